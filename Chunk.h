@@ -1,1542 +1,2963 @@
-﻿#pragma once
-#include <iterator>
-#include <memory>
-#include <list>
-#include <algorithm>
-#include <exception>
-#include <compare>
-#include <iostream>
-
-
-namespace fefu_laboratory_two {
-	template <typename T>
-	class Allocator {
-	public:
-		using value_type = T;
-		using size_type = std::size_t;
-		using difference_type = std::ptrdiff_t;
-		using pointer = T*;
-		using const_pointer = const T*;
-		using reference = T&;
-		using const_reference = const T&;
-
-
-		constexpr Allocator() noexcept {};
-
-		constexpr Allocator(const Allocator& other) noexcept = default;
-
-		template <class U>
-		constexpr Allocator(const Allocator<U>& other) noexcept {};
-
-		~Allocator() = default;
-
-		pointer allocate(size_type N) {
-			pointer ptr = static_cast<pointer>(::operator new(sizeof(value_type) * N));
-			if (ptr != nullptr) {
-				return ptr;
-			}
-			else {
-				throw std::bad_alloc();
-			}
-		}
-
-		void deallocate(pointer p, const size_t N) noexcept {
-			static_cast<void>(N);
-			free(p);
-		}
-	};
-
-	template <typename ValueType, typename Allocator = Allocator<ValueType>>
-	class Chunk {
-	public:
-		using size_type = std::size_t;
-		ValueType* list = nullptr;
-		Chunk* prev = nullptr;
-		Chunk* next = nullptr;
-		int chunk_size = 0;
-		int num_of_elements = 0;
-		Allocator allocator;
-
-		Chunk(int N) {
-			list = allocator.allocate(N);
-			chunk_size = N;
-		}
-
-		ValueType* get_data() {
-			ValueType* data = allocator.allocate(chunk_size);
-			for (int i = 0; i < chunk_size; i++)
-				data[i] = list[i];
-			return data;
-		}
-
-		ValueType* begin() {
-			return list;
-		}
-
-		ValueType* end() {
-			return list + num_of_elements;
-		}
-
-		void resize(size_type new_size) {
-			if (new_size < 0)
-				throw std::invalid_argument("New size cannot be negative");
-
-			if (new_size == chunk_size)
-				return;
-
-			size_type min_v = (chunk_size > new_size) ? new_size : chunk_size;
-			ValueType* new_list = allocator.allocate(new_size);
-			for (int i = 0; i < min_v; ++i) {
-				new_list[i] = list[i];
-			}
-
-			if (num_of_elements > new_size)
-				num_of_elements = new_size;
-
-			allocator.deallocate(list, chunk_size);
-			list = new_list;
-			chunk_size = new_size;
-		}
-
-		void resize(size_type new_size, const ValueType& value) {
-			if (new_size < 0)
-				throw std::invalid_argument("New size cannot be negative");
-
-			if (new_size == chunk_size)
-				return;
-			
-			ValueType* new_list = allocator.allocate(new_size);
-			if (new_size <= chunk_size) {
-				for (int i = 0; i < new_size; ++i) {
-					new_list[i] = list[i];
-				}
-			}
-			else {
-				for (int i = 0; i < chunk_size; ++i) {
-					new_list[i] = list[i];
-				}
-
-				for (int i = chunk_size; i < new_size; ++i) {
-					new_list[i] = value;
-				}
-			}
-
-
-			if (num_of_elements > new_size)
-				num_of_elements = new_size;
-
-			allocator.deallocate(list, chunk_size);
-			list = new_list;
-			chunk_size = new_size;
-			num_of_elements = new_size;
-		}
-	};
-
-	template<typename ValueType>
-	class ChunkListInterface {
-	public:
-		virtual ~ChunkListInterface() {}
-		virtual ValueType& at(size_t index) = 0;
-		virtual const ValueType& at(size_t index) const = 0;
-		virtual size_t size() const noexcept = 0;
-		virtual ValueType& operator[](std::ptrdiff_t n) = 0;
-		virtual const ValueType& operator[](std::ptrdiff_t n) const = 0;
-	};
-
-	template <typename ValueType>
-	class ChunkList_iterator {
-	protected:
-		int elem_index = 0;
-		ChunkListInterface<ValueType>* list = nullptr;
-		ValueType* current_value = nullptr;
-	public:
-		using iterator_category = std::random_access_iterator_tag;
-		using value_type = ValueType;
-		using difference_type = std::ptrdiff_t;
-		using pointer = ValueType*;
-		using reference = ValueType&;
-
-		int get_index() { return elem_index; };
-
-		constexpr ChunkList_iterator() noexcept = default;
-
-		ChunkList_iterator(ChunkListInterface<ValueType>* chunk, int index, ValueType* value) :
-			list(chunk),
-			elem_index(index),
-			current_value(value)
-		{
-		};
-
-		ChunkList_iterator(const ChunkList_iterator<ValueType>& other)
-		{
-			list = other.list;
-			elem_index = other.elem_index;
-			current_value = other.current_value;
-		};
-
-		ChunkList_iterator& operator=(const ChunkList_iterator& other) {
-			list = other.list;
-			elem_index = other.elem_index;
-			current_value = other.current_value;
-		};
-
-		~ChunkList_iterator() = default;
-
-		void swap(ChunkList_iterator<ValueType>& a, ChunkList_iterator<ValueType>& b) {
-			std::swap(a.list, b.list);
-			std::swap(a.current_value, b.current_value);
-			std::swap(a.elem_index, b.elem_index);
-		};
-
-		friend bool operator==(const ChunkList_iterator<ValueType>& lhs,
-			const ChunkList_iterator<ValueType>& rhs) {
-			return lhs.current_value == rhs.current_value;
-		};
-
-		friend bool operator!=(const ChunkList_iterator<ValueType>& lhs,
-			const ChunkList_iterator<ValueType>& rhs) {
-			return !(lhs.current_value == rhs.current_value);
-		};
-
-		reference operator*() const { return *current_value; };
-		pointer operator->() const { return current_value; };
-
-		ChunkList_iterator operator++(int) {
-			if (elem_index + 1 == list->size())
-				return ChunkList_iterator();
-			elem_index++;
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-		ChunkList_iterator operator--(int) {
-			elem_index--;
-			if (elem_index <= -1)
-				return *this;
-
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-
-		ChunkList_iterator& operator++() {
-			if (elem_index + 1 == list->size()) {
-				current_value = nullptr;
-				list = nullptr;
-				elem_index = 0;
-				return *this;
-			}
-			elem_index++;
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-
-		ChunkList_iterator& operator--() {
-			elem_index--;
-			if (elem_index <= -1)
-				return *this;
-
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-
-		ChunkList_iterator operator+(const difference_type& n) const {
-			return ChunkList_iterator(list, elem_index + n, &list->at(elem_index + n));
-		};
-
-
-		ChunkList_iterator operator-(const difference_type& n) const {
-			return ChunkList_iterator(list, elem_index - n, &list->at(elem_index - n));
-		};
-
-		ChunkList_iterator& operator+=(const difference_type& n) {
-			elem_index += n;
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-
-		ChunkList_iterator& operator-=(const difference_type& n) {
-			elem_index -= n;
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-
-
-		reference operator[](const difference_type& n) {
-			return list[n];
-		};
-
-		friend bool operator<(const ChunkList_iterator<ValueType>& lhs,
-			const ChunkList_iterator<ValueType>& rhs) {
-			return lhs.elem_index < rhs.elem_index;
-		};
-		friend bool operator<=(const ChunkList_iterator<ValueType>& lhs,
-			const ChunkList_iterator<ValueType>& rhs) {
-			return lhs.elem_index <= rhs.elem_index;
-		};
-		friend bool operator>(const ChunkList_iterator<ValueType>& lhs,
-			const ChunkList_iterator<ValueType>& rhs) {
-			return lhs.elem_index > rhs.elem_index;
-		};
-		friend bool operator>=(const ChunkList_iterator<ValueType>& lhs,
-			const ChunkList_iterator<ValueType>& rhs) {
-			return lhs.elem_index >= rhs.elem_index;
-		};
-	};
-
-	template <typename ValueType>
-	class ChunkList_const_iterator {
-	public:
-		int elem_index = 0;
-		const ChunkListInterface<ValueType>* list = nullptr;
-		const ValueType* current_value = nullptr;
-
-		using iterator_category = std::random_access_iterator_tag;
-		using value_type = ValueType;
-		using difference_type = std::ptrdiff_t;
-		using const_pointer = const ValueType*;
-		using const_reference = const ValueType&;
-
-		const int get_index() const { return elem_index; };
-
-		ChunkList_iterator<ValueType> constIteratorToIterator() {
-			return ChunkList_iterator<ValueType>(const_cast<ChunkListInterface<ValueType>*>(list), elem_index, const_cast<ValueType*>(current_value));
-		}
-
-		constexpr ChunkList_const_iterator() noexcept = default;
-
-		ChunkList_const_iterator(ChunkListInterface<ValueType>* chunk, int index, ValueType* value) :
-			list(chunk),
-			elem_index(index),
-			current_value(value) 
-		{
-		};
-
-		ChunkList_const_iterator(const ChunkListInterface<ValueType>* chunk, int index, const ValueType* value) :
-			list(chunk),
-			elem_index(index),
-			current_value(value) 
-		{	
-		};
-
-		ChunkList_const_iterator(const ChunkList_const_iterator<ValueType>& other) {
-			list = other.list;
-			elem_index = other.elem_index;
-			current_value = other.current_value;
-		};
-
-		ChunkList_const_iterator& operator=(const ChunkList_const_iterator&) = default;
-
-		~ChunkList_const_iterator() = default;
-
-		void swap(ChunkList_const_iterator<ValueType>& a, ChunkList_const_iterator<ValueType>& b) {
-			std::swap(a.list, b.list);
-			std::swap(a.current_value, b.current_value);
-			std::swap(a.elem_index, b.elem_index);
-		};
-
-		friend bool operator==(const ChunkList_const_iterator<ValueType>& lhs,
-			const ChunkList_const_iterator<ValueType>& rhs) {
-			return lhs.current_value == rhs.current_value;
-		};
-		friend bool operator!=(const ChunkList_const_iterator<ValueType>& lhs,
-			const ChunkList_const_iterator<ValueType>& rhs) {
-			return lhs.current_value != rhs.current_value;
-		};
-
-		const_reference operator*() const { return *current_value; };
-		const_pointer operator->() const { return current_value; };
-		const_reference operator[](const difference_type& n) {
-			return list[n];
-		};
-
-		ChunkList_const_iterator operator++(int) {
-			if (elem_index + 1 == list->size())
-				return ChunkList_const_iterator();
-			elem_index++;
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-
-		ChunkList_const_iterator operator--(int) {
-			return ChunkList_iterator<ValueType>::operator--(0);
-		};
-
-		ChunkList_const_iterator& operator++() {
-			if (elem_index + 1 == list->size()) {
-				current_value = nullptr;
-				list = nullptr;
-				elem_index = 0;
-				return *this;
-			}
-			elem_index++;
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-
-		ChunkList_const_iterator& operator--() {
-			if (elem_index - 1 == -1)
-				throw std::exception();
-			elem_index--;
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-
-		ChunkList_const_iterator operator+(const difference_type& n) const {
-			return ChunkList_const_iterator(list, elem_index + n, &list->at(elem_index + n));
-		};
-
-
-		ChunkList_const_iterator operator-(const difference_type& n) const {
-			return ChunkList_const_iterator(list, elem_index - n, &list->at(elem_index - n));
-		};
-
-		ChunkList_const_iterator& operator+=(const difference_type& n) {
-			elem_index += n;
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-
-		ChunkList_const_iterator& operator-=(const difference_type& n) {
-			elem_index -= n;
-			current_value = &list->at(elem_index);
-			return *this;
-		};
-
-		friend bool operator<(const ChunkList_const_iterator<ValueType>& lhs,
-			const ChunkList_const_iterator<ValueType>& rhs) {
-			return lhs.elem_index < rhs.elem_index;
-		};
-		friend bool operator<=(const ChunkList_const_iterator<ValueType>& lhs,
-			const ChunkList_const_iterator<ValueType>& rhs) {
-			return lhs.elem_index <= rhs.elem_index;
-		};
-		friend bool operator>(const ChunkList_const_iterator<ValueType>& lhs,
-			const ChunkList_const_iterator<ValueType>& rhs) {
-			return lhs.elem_index > rhs.elem_index;
-		};
-		friend bool operator>=(const ChunkList_const_iterator<ValueType>& lhs,
-			const ChunkList_const_iterator<ValueType>& rhs) {
-			return lhs.elem_index >= rhs.elem_index;
-		};
-	};
-
-	template <typename T, int N, typename Allocator = Allocator<T>>
-	class ChunkList : public ChunkListInterface<T> {
-	protected:
-		Chunk<T, Allocator>* first_chunk = nullptr;
-		int list_size = 0;
-		int chunk_size = N;
-	public:
-
-		using value_type = T;
-		using allocator_type = Allocator;
-		using size_type = std::size_t;
-		using difference_type = std::ptrdiff_t;
-		using reference = value_type&;
-		using const_reference = const value_type&;
-		using pointer = typename std::allocator_traits<Allocator>::pointer;
-		using const_pointer = typename std::allocator_traits<Allocator>::const_pointer;
-		using iterator = ChunkList_iterator<value_type>;
-		using const_iterator = ChunkList_const_iterator<value_type>;
-
-		/// @brief Default constructor. Constructs an empty container with a
-		/// default-constructed allocator.
-		ChunkList() : first_chunk(new Chunk<value_type>(N)) {};
-
-		/// @brief Constructs an empty container with the given allocator
-		/// @param alloc allocator to use for all memory allocations of this container
-		/// s
-		/*explicit ChunkList(const Allocator& alloc);*/
-
-		/// @brief Constructs the container with count copies of elements with value
-		/// and with the given allocator
-		/// @param count the size of the container
-		/// @param value the value to initialize elements of the container with
-		/// @param alloc allocator to use for all memory allocations of this container
-		ChunkList(size_type count, const T& value = T(), const Allocator& alloc = Allocator())
-			: first_chunk(new Chunk<value_type, allocator_type>(N))
-		{
-			int i = 0;
-			auto current_chunk = first_chunk;
-			while (i < count) {
-				current_chunk->allocator = alloc;
-				for (int j = 0; j < N; j++) {
-					current_chunk->list[j] = value;
-					i++;
-					if (i == count) {
-						break;
-					}
-				}
-				if (i < count) {
-					current_chunk->next = new Chunk<value_type, allocator_type>(N);
-					current_chunk = current_chunk->next;
-				}
-			}
-		};
-
-		/// @brief Constructs the container with count default-inserted instances of
-		/// T. No copies are made.
-		/// @param count the size of the container
-		/// @param alloc allocator to use for all memory allocations of this container
-		explicit ChunkList(size_type count, const Allocator& alloc = Allocator())
-			: first_chunk(new Chunk<value_type, allocator_type>(N))
-		{
-			int i = 0;
-			Chunk<value_type, allocator_type>* current_chunk = first_chunk;
-			while (i < count) {
-				current_chunk->allocator = alloc;
-				for (int j = 0; j < N; j++) {
-					current_chunk->list[j] = T();
-					i++;
-					if (i == count)
-						break;
-				}
-				if (i < count) {
-					current_chunk->next = new Chunk<value_type, allocator_type>(N);
-					current_chunk = current_chunk->next;
-				}
-			}
-		};
-
-		/// @brief Constructs the container with the contents of the range [first,
-		/// last).
-		/// @tparam InputIt Input Iterator
-		/// @param first, last 	the range to copy the elements from
-		/// @param alloc allocator to use for all memory allocations of this container
-		template <class InputIt>
-		ChunkList(InputIt first, InputIt last, const Allocator& alloc = Allocator()) 
-			: first_chunk(new Chunk<value_type, allocator_type>(N))
-		{
-			Chunk<value_type, allocator_type>* current_chunk = first_chunk;
-			auto it = first;
-			int i = 0;
-			while (it != last) {
-				current_chunk->allocator = alloc;	
-				for (i = 0; i < N && it != last; ++i, ++it) {
-					current_chunk->list[i] = *it;
-					current_chunk->num_of_elements++;
-					list_size++;
-					if (it == last)
-						break;
-				}
-				if (it != last) {
-					current_chunk->next = new Chunk<value_type, allocator_type>(N);
-					current_chunk = current_chunk->next;
-				}
-			}
-		};
-
-		/// @brief Copy constructor. Constructs the container with the copy of the
-		/// contents of other.
-		/// @param other another container to be used as source to initialize the
-		/// elements of the container with
-		ChunkList(const ChunkList& other)  {
-			first_chunk = new Chunk<value_type>(N);
-			Chunk<value_type>* old_list = other.first_chunk;
-			Chunk<value_type>* new_list = first_chunk;
-
-			while (old_list != nullptr) {
-				new_list->list = old_list->get_data();
-				new_list->chunk_size = old_list->chunk_size;
-				if (old_list->next != nullptr) {
-					new_list->next = new Chunk<value_type>(N);
-					Chunk<value_type>* tmp = new_list;
-					new_list = new_list->next;
-					new_list->prev = tmp;
-				}
-				old_list = old_list->next;
-			}
-			list_size = other.list_size;
-		};
-
-		/// @brief Constructs the container with the copy of the contents of other,
-		/// using alloc as the allocator.
-		/// @param other another container to be used as source to initialize the
-		/// elements of the container with
-		/// @param alloc allocator to use for all memory allocations of this container
-		ChunkList(const ChunkList& other, const Allocator& alloc) {
-			this = ChunkList(other);
-			Chunk<value_type, allocator_type>* current_chunk = this->first_chunk;
-			while (current_chunk != nullptr) {
-				current_chunk->allocator = alloc;
-				current_chunk = current_chunk->next;
-			}
-		};
-
-		/**
-		 * @brief Move constructor.
-		 *
-		 * Constructs the container with the contents of other using move semantics.
-		 * Allocator is obtained by move-construction from the allocator belonging to
-		 * other.
-		 *
-		 * @param other another container to be used as source to initialize the
-		 * elements of the container with
-		 */
-		ChunkList(ChunkList&& other) {
-			first_chunk = std::move(other.first_chunk);
-			list_size = std::move(other.list_size);
-			other.clear();
-		};
-
-		/**
-		 * @brief Allocator-extended move constructor.
-		 * Using alloc as the allocator for the new container, moving the contents
-		 * from other; if alloc != other.get_allocator(), this results in an
-		 * element-wise move.
-		 *
-		 * @param other another container to be used as source to initialize the
-		 * elements of the container with
-		 * @param alloc allocator to use for all memory allocations of this container
-		 */
-		ChunkList(ChunkList&& other, const Allocator& alloc) {
-			this = ChunkList(other);
-			Chunk<value_type, allocator_type>* current_chunk = first_chunk;
-			while (current_chunk != nullptr) {
-				current_chunk->allocator = alloc;
-				current_chunk = current_chunk->next;
-			}
-		};
-
-		/// @brief Constructs the container with the contents of the initializer list
-		/// init.
-		/// @param init initializer list to initialize the elements of the container
-		/// with
-		/// @param alloc allocator to use for all memory allocations of this container
-		ChunkList(std::initializer_list<T> init, const Allocator& alloc = Allocator())
-			: first_chunk(new Chunk<value_type, allocator_type>(N))
-		{
-			first_chunk->allocator = alloc;
-			auto it = init.begin();
-			Chunk<value_type, allocator_type>* current_chunk = first_chunk;
-			int count = 0;
-			while (it != init.end()) {
-				current_chunk->list[count] = *it;
-				++count;
-				++it;
-				if (count == N) {
-					current_chunk->next = new Chunk<value_type, allocator_type>(N);
-					current_chunk = current_chunk->next;
-					count = 0;
-				}
-			}
-			list_size = init.size();
-		}
-
-		/// @brief Destructs the ChunkList.
-		~ChunkList() {
-			clear();
-		};
-
-		/// @brief Copy assignment operator. Replaces the contents with a copy of the
-		/// contents of other.
-		/// @param other another container to use as data source
-		/// @return *this
-		ChunkList& operator=(const ChunkList& other) {
-			(this) = new ChunkList(other);
-			return (*this);
-		};
-
-		/**
-		 * Move assignment operator.
-		 *
-		 * Replaces the contents with those of other using move semantics
-		 * (i.e. the data in other is moved from other into this container).
-		 * other is in a valid but unspecified state afterwards.
-		 *
-		 * @param other another container to use as data source
-		 * @return *this
-		 */
-		ChunkList& operator=(ChunkList&& other) {
-			first_chunk = std::move(other.first_chunk);
-			list_size = std::move(other.list_size);
-			other.clear();
-
-			return *this;
-		};
-
-		/// @brief Replaces the contents with those identified by initializer list
-		/// ilist.
-		/// @param ilist
-		/// @return this
-		ChunkList& operator=(std::initializer_list<T> ilist) {
-			clear();
-			auto it = ilist.begin();
-			Chunk* current_chunk = first_chunk;
-			int count = 0;
-			for (const auto& elem : ilist) {
-				current_chunk->list[count] = elem;
-				++count;
-				if (count == N) {
-					if (current_chunk->next == nullptr) {
-						current_chunk->next = new Chunk<value_type, allocator_type>(N);
-						current_chunk->next->prev = current_chunk;
-					}
-					current_chunk = current_chunk->next;
-					count = 0;
-				}
-			}
-			list_size = ilist.size();
-			return *this;
-		}
-
-		/// @brief Replaces the contents with count copies of value
-		/// @param count
-		/// @param value
-		void assign(size_type count, const T& value) {
-			if (count < 0)
-				throw std::out_of_range("Count argument must be non-negative");
-			clear();
-			for (int i = 0; i < count; i++)
-				push_back(value);
-			list_size = count;
-		};
-
-		/// @brief Replaces the contents with copies of those in the range [first,
-		/// last).
-		/// @tparam InputIt
-		/// @param first
-		/// @param last
-		template <class InputIt>
-		void assignIt(InputIt first, InputIt last) {
-			clear();
-			for (InputIt it = first; it != last; ++it) {
-				push_back(*it);
-			}
-		}
-
-		/// @brief Replaces the contents with the elements from the initializer list
-		/// ilis
-		/// @param ilist
-		void assign(std::initializer_list<T> ilist) {
-			clear();
-			for (const auto& value : ilist) {
-				push_back(value);
-			}
-		}
-
-		/// @brief Returns the allocator associated with the container.
-		/// @return The associated allocator.
-		allocator_type get_allocator() const noexcept {
-			return first_chunk->allocator;
-		};
-
-		Chunk<value_type, allocator_type>* last_chunk() {
-			Chunk<value_type, allocator_type>* current_chunk = first_chunk;
-			while (current_chunk->next != nullptr)
-				current_chunk = current_chunk->next;
-			return current_chunk;
-		}
-
-		/// ELEMENT ACCESS
-
-		/// @brief Returns a reference to the element at specified location pos, with
-		/// bounds checking. If pos is not within the range of the container, an
-		/// exception of type std::out_of_range is thrown.
-		/// @param pos position of the element to return
-		/// @return Reference to the requested element.
-		/// @throw std::out_of_range
-		reference at(size_type pos) {
-			if (pos >= max_size() || pos < 0) {
-				throw std::out_of_range("Out of range");
-			}
-			int chunk_index = pos / chunk_size;
-			int elemnt_index = pos % chunk_size;
-
-			Chunk<value_type, allocator_type>* curr_chunk = first_chunk;
-			while (chunk_index > 0) {
-				curr_chunk = curr_chunk->next;
-				chunk_index--;
-			}
-			return curr_chunk->list[elemnt_index];
-		};
-
-		/// @brief Returns a const reference to the element at specified location pos,
-		/// with bounds checking. If pos is not within the range of the container, an
-		/// exception of type std::out_of_range is thrown.
-		/// @param pos position of the element to return
-		/// @return Const Reference to the requested element.
-		/// @throw std::out_of_range
-		const_reference at(size_type pos) const {
-			if (pos >= max_size() || pos < 0) {
-				throw std::out_of_range("Out of range");
-			}
-			int chunk_index = pos / N;
-			int elemnt_index = pos % N;
-
-			Chunk<value_type, allocator_type>* curr_chunk = first_chunk;
-			while (chunk_index > 0) {
-				curr_chunk = curr_chunk->next;
-				chunk_index--;
-			}
-			return curr_chunk->list[elemnt_index];
-		};
-
-		/// @brief Returns a reference to the element at specified location pos. No
-		/// bounds checking is performed.
-		/// @param pos position of the element to return
-		/// @return Reference to the requested element.
-		reference operator[](difference_type pos) {
-			int chunk_index = pos / N;
-			int elemnt_index = pos % N;
-
-			Chunk<value_type, allocator_type>* curr_chunk = first_chunk;
-			while (chunk_index > 0) {
-				curr_chunk = curr_chunk->next;
-				chunk_index--;
-			}
-			return curr_chunk->list[elemnt_index];
-		};
-
-		/// @brief Returns a const reference to the element at specified location pos.
-		/// No bounds checking is performed.
-		/// @param pos position of the element to return
-		/// @return Const Reference to the requested element.
-		const_reference operator[](difference_type pos) const {
-			int chunk_index = pos / N;
-			int elemnt_index = pos % N;
-
-			Chunk<value_type, allocator_type>* curr_chunk = first_chunk;
-			while (chunk_index > 0) {
-				curr_chunk = curr_chunk->next;
-				chunk_index--;
-			}
-			return curr_chunk->list[elemnt_index];
-		};
-
-		/// @brief Returns a reference to the first element in the container.
-		/// Calling front on an empty container is undefined.
-		/// @return Reference to the first element
-		reference front() {
-			if (list_size == 0)
-				throw std::logic_error("Empty");
-
-			return first_chunk->list[0];
-		};
-
-		/// @brief Returns a const reference to the first element in the container.
-		/// Calling front on an empty container is undefined.
-		/// @return Const reference to the first element
-		const_reference front() const {
-			if (list_size == 0)
-				throw std::logic_error("Empty");
-
-			return first_chunk->list[0];
-		};
-
-		/// @brief Returns a reference to the last element in the container.
-		/// Calling back on an empty container causes undefined behavior.
-		/// @return Reference to the last element.
-		reference back() {
-			if (list_size == 0)
-				throw std::logic_error("Empty");
-
-			Chunk<value_type, allocator_type>* curr_chunk = last_chunk();
-
-			return curr_chunk->list[curr_chunk->num_of_elements - 1];
-		};
-
-		/// @brief Returns a const reference to the last element in the container.
-		/// Calling back on an empty container causes undefined behavior.
-		/// @return Const Reference to the last element.
-		const_reference back() const {
-			if(list_size == 0)
-				throw std::logic_error("Empty");
-
-			Chunk<value_type, allocator_type>* curr_chunk = last_chunk();
-
-			return curr_chunk->list[curr_chunk->num_of_elements - 1];
-		};
-
-		/// ITERATORS
-
-		/// @brief Returns an iterator to the first element of the ChunkList.
-		/// If the ChunkList is empty, the returned iterator will be equal to end().
-		/// @return Iterator to the first element.
-		iterator begin() noexcept {
-			return ChunkList_iterator<T>(this, 0, &at(0));
-		};
-
-		/// @brief Returns an iterator to the first element of the ChunkList.
-		/// If the ChunkList is empty, the returned iterator will be equal to end().
-		/// @return Iterator to the first element.
-		const_iterator begin() const noexcept {
-			return ChunkList_const_iterator<T>(this, 0, &at(0));
-		};
-
-		/// @brief Same to begin()
-		const_iterator cbegin() const noexcept { return begin(); };
-
-		/// @brief Returns an iterator to the element following the last element of
-		/// the ChunkList. This element acts as a placeholder; attempting to access it
-		/// results in undefined behavior.
-		/// @return Iterator to the element following the last element.
-		iterator end() noexcept {
-			return ChunkList_iterator<T>();
-		};
-
-		/// @brief Returns an constant iterator to the element following the last
-		/// element of the ChunkList. This element acts as a placeholder; attempting to
-		/// access it results in undefined behavior.
-		/// @return Constant Iterator to the element following the last element.
-		const_iterator end() const noexcept {
-			return ChunkList_const_iterator<T>();
-		};
-
-		/// @brief Same to end()
-		const_iterator cend() const noexcept { return end(); };
-
-		/// CAPACITY
-
-		/// @brief Checks if the container has no elements
-		/// @return true if the container is empty, false otherwise
-		bool empty() const noexcept { return list_size == 0; };
-
-		/// @brief Returns the number of elements in the container
-		/// @return The number of elements in the container.
-		size_type size() const noexcept { return list_size; };
-
-		/// @brief Returns the maximum number of elements the container is able to
-		/// hold due to system or library implementation limitations
-		/// @return Maximum number of elements.
-		size_type max_size() const noexcept {
-			int r = list_size % chunk_size;
-			return (r == 0 ? list_size : list_size + N - r);
-		};
-
-		/// @brief Requests the removal of unused capacity.
-		/// It is a non-binding request to reduce the memory usage without changing
-		/// the size of the sequence. All iterators and references are invalidated.
-		/// Past-the-end iterator is also invalidated.
-		void shrink_to_fit() {
-			Chunk<value_type, allocator_type>* curr_chunk = last_chunk();
-
-			// We are at the last chunk, release the extra memory
-			Chunk<value_type, allocator_type>* new_chunk = new Chunk<value_type, allocator_type>(N);
-			for (size_type i = 0; i < curr_chunk->chunk_size; ++i) {
-				new_chunk->list[i] = std::move<value_type>(curr_chunk->list[i]);
-			}
-			new_chunk->num_of_elements = curr_chunk->num_of_elements;
-
-			delete[] curr_chunk->list;
-			curr_chunk->list = new_chunk->list;
-			curr_chunk->next = new_chunk;
-		}
-
-		/// MODIFIERS
-
-		/// @brief Erases all elements from the container.
-		/// nvalidates any references, pointers, or iterators referring to contained
-		/// elements. Any past-the-end iterators are also invalidated.
-		void clear() noexcept {
-			Chunk<value_type, allocator_type>* cur = first_chunk;
-			while (cur != nullptr) {
-				Chunk<value_type, allocator_type>* tmp = cur;
-				cur = cur->next;
-				delete tmp;
-			}
-			list_size = 0;
-			first_chunk = nullptr;
-		};
-
-		/// @brief Inserts value before pos.
-		/// @param pos iterator before which the content will be inserted.
-		/// @param value element value to insert
-		/// @return Iterator pointing to the inserted value.
-		iterator insert(const_iterator pos, const T& value) {
-			if (pos == cend()) {
-				push_back(value);
-				return end();
-			}
-			int index = pos.get_index();
-			int i = 0;
-			ChunkList_iterator<T> tmpPos = pos.constIteratorToIterator();
-			Chunk<value_type, allocator_type>* curr_chunk = last_chunk();
-			if (max_size() > list_size) {
-				ChunkList_iterator<T> it = ChunkList_iterator<T>(
-					this,
-					list_size - 1,
-					&curr_chunk->list[curr_chunk->chunk_size - 1]
-				);
-				for (; it >= tmpPos; it--, i++)
-					at(list_size - i) = at(list_size - i - 1);
-				list_size++;
-			}
-			else {
-				curr_chunk->next = new Chunk<value_type, allocator_type>(N);
-				ChunkList_iterator<T> it = ChunkList_iterator<T>(
-					this,
-					list_size - 1,
-					&curr_chunk->list[curr_chunk->chunk_size - 1]
-				);
-				Chunk<value_type, allocator_type>* tmp = curr_chunk;
-				curr_chunk = curr_chunk->next;
-				curr_chunk->prev = tmp;
-				list_size++;
-				for (; it >= tmpPos; it--, i++)
-					at(list_size - 1 - i) = at(list_size - i - 2);
-			}
-			at(index) = value;
-			curr_chunk->num_of_elements++;
-			return ChunkList_iterator<T>(this, index, &at(index));
-		};
-
-		/// @brief Inserts value before pos.
-		/// @param pos iterator before which the content will be inserted.
-		/// @param value element value to insert
-		/// @return Iterator pointing to the inserted value.
-		iterator insert(const_iterator pos, T&& value) {
-			if (pos == cend()) {
-				push_back(value);
-				return end();
-			}
-			int index = pos.get_index();
-			int i = 0;
-			ChunkList_iterator<T> tmpPos = pos.constIteratorToIterator();
-			Chunk<value_type, allocator_type>* curr_chunk = last_chunk();
-			if (max_size() > list_size) {
-				ChunkList_iterator<T> it = ChunkList_iterator<T>(
-					this,
-					list_size - 1,
-					&curr_chunk->list[curr_chunk->chunk_size - 1]
-				);
-				for (; it >= tmpPos; it--, i++)
-					at(list_size - i) = at(list_size - i - 1);
-				list_size++;
-			}
-			else {
-				curr_chunk->next = new Chunk<value_type, allocator_type>(N);
-				ChunkList_iterator<T> it = ChunkList_iterator<T>(
-					this,
-					list_size - 1,
-					&curr_chunk->list[curr_chunk->chunk_size - 1]
-				);
-				Chunk<value_type, allocator_type>* tmp = curr_chunk;
-				curr_chunk = curr_chunk->next;
-				curr_chunk->prev = tmp;
-				list_size++;
-				for (; it >= tmpPos; it--, i++)
-					at(list_size - 1 - i) = at(list_size - i - 2);
-			}
-			at(index) = std::move(value);
-			curr_chunk->num_of_elements++;
-			return ChunkList_iterator<T>(this, index, &at(index));
-		};
-
-		private:
-		Chunk<value_type, allocator_type>* get_chunk_at_index(size_type index) const {
-			int chunk_index = index / N;
-			Chunk<value_type, allocator_type>* curr_chunk = first_chunk;
-			while (chunk_index > 0) {
-				curr_chunk = curr_chunk->next;
-				chunk_index--;
-			}
-			return curr_chunk;
-		}
-
-		size_type get_start_index_of_chunk(Chunk<value_type, allocator_type>* chunk) const {
-			size_type index = 0;
-			Chunk<value_type, allocator_type>* curr_chunk = first_chunk;
-			while (curr_chunk != chunk) {
-				index += N;
-				curr_chunk = curr_chunk->next;
-			}
-			return index;
-		}
-
-		public:
-		/// @brief Inserts count copies of the value before pos.
-		/// @param pos iterator before which the content will be inserted.
-		/// @param count number of elements to insert
-		/// @param value element value to insert
-		/// @return Iterator pointing to the first element inserted, or pos if count
-		/// == 0.
-		iterator insert(const_iterator pos, size_type count, const T& value) {
-			if (count == 0) {
-				return ChunkList_iterator<T>(this, pos.get_index(), &at(pos.get_index()));
-			}
-			if (pos == cend()) {
-				for (size_type i = 0; i < count; ++i) {
-					push_back(value);
-				}
-				return ChunkList_iterator<T>(this, list_size - 1, &at(list_size - 1));
-			}
-
-			size_type index = pos.get_index();
-			Chunk<value_type, allocator_type>* curr_chunk = get_chunk_at_index(index);
-			size_type offset = index - get_start_index_of_chunk(curr_chunk);
-
-			while (count > 0) {
-				if (curr_chunk->num_of_elements < N - offset) {
-					size_type num_to_copy = std::min(count, N - offset);
-					std::copy_backward(curr_chunk->list + offset, curr_chunk->list + curr_chunk->num_of_elements,
-						curr_chunk->list + curr_chunk->num_of_elements + num_to_copy);
-					std::fill(curr_chunk->list + offset, curr_chunk->list + offset + num_to_copy, value);
-					count -= num_to_copy;
-					offset = 0;
-					curr_chunk->num_of_elements = N;
-				}
-				else {
-					Chunk<value_type, allocator_type>* new_chunk = new Chunk<value_type, allocator_type>();
-					new_chunk->prev = curr_chunk;
-					new_chunk->next = curr_chunk->next;
-					if (curr_chunk->next != nullptr) {
-						curr_chunk->next->prev = new_chunk;
-					}
-					curr_chunk->next = new_chunk;
-					curr_chunk = new_chunk;
-				}
-			}
-
-			list_size += count;
-			return ChunkList_iterator<T>(this, index, &at(index));
-		}
-
-		Chunk<value_type, allocator_type>* insert_chunk_after(Chunk<value_type, allocator_type>* chunk) {
-			Chunk<value_type, allocator_type>* new_chunk = new Chunk<value_type, allocator_type>();
-			new_chunk->next = chunk->next;
-			new_chunk->prev = chunk;
-			if (chunk->next != nullptr) {
-				chunk->next->prev = new_chunk;
-			}
-			chunk->next = new_chunk;
-			return new_chunk;
-		}
-
-		/// @brief Inserts elements from range [first, last) before pos.
-		/// @tparam InputIt Input Iterator
-		/// @param pos iterator before which the content will be inserted.
-		/// @param first,last the range of elements to insert, can't be iterators into
-		/// container for which insert is called
-		/// @return Iterator pointing to the first element inserted, or pos if first
-		/// == last.
-		template <class InputIt>
-		iterator insert(const_iterator pos, InputIt first, InputIt last) {
-			size_type index = pos.get_index();
-			Chunk<value_type, allocator_type>* curr_chunk = get_chunk_at_index(index);
-			size_type offset = index - get_start_index_of_chunk(curr_chunk);
-
-			while (first != last) {
-				if (offset == N) {
-					curr_chunk = insert_chunk_after(curr_chunk);
-					offset = 0;
-				}
-				if (curr_chunk->num_of_elements < N - offset) {
-					size_type num_to_copy = std::min(static_cast<size_type>(std::distance(first, last)), N - offset);
-					std::copy(first, first + num_to_copy, curr_chunk->list + offset);
-					std::advance(first, num_to_copy);
-					offset += num_to_copy;
-					curr_chunk->num_of_elements += num_to_copy;
-				}
-			}
-
-			list_size += std::distance(first, last);
-			return ChunkList_iterator<T>(this, index, &at(index));
-		}
-
-		/// @brief Inserts elements from initializer list before pos.
-		/// @param pos iterator before which the content will be inserted.
-		/// @param ilist initializer list to insert the values from
-		/// @return Iterator pointing to the first element inserted, or pos if ilist
-		/// is empty.
-		iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
-			size_type index = pos.get_index();
-			Chunk<value_type, allocator_type>* curr_chunk = get_chunk_at_index(index);
-			size_type offset = index - get_start_index_of_chunk(curr_chunk);
-
-			for (const auto& value : ilist) {
-				if (offset == N) {
-					curr_chunk = insert_chunk_after(curr_chunk);
-					offset = 0;
-				}
-				if (curr_chunk->num_of_elements < N - offset) {
-					curr_chunk->list[offset] = value;
-					++offset;
-					++curr_chunk->num_of_elements;
-				}
-			}
-
-			list_size += ilist.size();
-			return ChunkList_iterator<T>(this, index, &at(index));
-		}
-
-		/// @brief Inserts a new element into the container directly before pos.
-		/// @param pos iterator before which the new element will be constructed
-		/// @param ...args arguments to forward to the constructor of the element
-		/// @return terator pointing to the emplaced element.
-		template <class... Args>
-		iterator emplace(const_iterator pos, Args&&... args) {
-			return insert(pos, T(std::forward<Args>(args)...));
-		}
-
-		/// @brief Removes the element at pos.
-		/// @param pos iterator to the element to remove
-		/// @return Iterator following the last removed element.
-		iterator erase(const_iterator pos) {
-			auto index = pos.get_index();
-			Chunk<value_type, allocator_type>* curr_chunk = last_chunk();
-
-			if (index + 1 == list_size) {
-				list_size--;
-				curr_chunk->num_of_elements--;
-				return end();
-			}
-
-			for (int i = index + 1; i < list_size; i++) {
-				at(i - 1) = at(i);
-			}
-
-			if (list_size == max_size() - N + 1) {
-				curr_chunk = curr_chunk->prev;
-				delete curr_chunk->next;
-				curr_chunk->next = nullptr;
-			}
-			else {
-				curr_chunk->num_of_elements--;
-			}
-
-			list_size--;
-			return ChunkList_iterator<T>(this, index, &at(index));
-		};
-
-		/// @brief Removes the elements in the range [first, last).
-		/// @param first,last range of elements to remove
-		/// @return Iterator following the last removed element.
-		iterator erase(const_iterator first, const_iterator last) {
-			auto start_index = first.get_index();
-			auto end_index = last.get_index();
-
-			// Сдвигаем элементы влево, удаляя элементы в указанном диапазоне
-			size_type shift = end_index - start_index + 1;
-			for (size_type i = end_index + 1; i < list_size; ++i) {
-				at(i - shift) = at(i);
-			}
-
-			// Обновляем переменную общее кол-во элементов
-			list_size -= shift;
-
-			// Проверяем и обновляем чанки при необходимости
-			Chunk<value_type, allocator_type>* start_chunk = get_chunk_at_index(start_index);
-			Chunk<value_type, allocator_type>* end_chunk = get_chunk_at_index(end_index);
-			if (end_chunk != start_chunk) {
-				start_chunk->next = end_chunk->next;
-				if (end_chunk->next != nullptr) {
-					end_chunk->next->prev = start_chunk;
-				}
-				else {
-					end_chunk = start_chunk;
-				}
-			}
-			end_chunk->num_of_elements -= shift - (end_index % N) - 1;
-
-			// Возвращаем итератор, указывающий на первый элемент после удаленного диапазона
-			return ChunkList_iterator<T>(this, start_index, &at(start_index));
-		}
-
-		/// @brief Appends the given element value to the end of the container.
-		/// The new element is initialized as a copy of value.
-		/// @param value the value of the element to append
-		void push_back(const T& value) {
-			if (first_chunk == nullptr) {
-				first_chunk = new Chunk<value_type, allocator_type>(N);
-			}
-
-			Chunk<value_type, allocator_type>* curr_chunk = last_chunk();
-			if (curr_chunk->num_of_elements == N) {
-				curr_chunk->next = new Chunk<value_type, allocator_type>(N);
-				Chunk<value_type, allocator_type>* prev = curr_chunk;
-				curr_chunk = curr_chunk->next;
-				curr_chunk->prev = prev;
-			}
-			curr_chunk->list[curr_chunk->num_of_elements++] = value;
-			list_size++;
-		}
-
-		/// @brief Appends the given element value to the end of the container.
-		/// Value is moved into the new element.
-		/// @param value the value of the element to append
-		void push_back(T&& value) {
-			if (first_chunk == nullptr)
-				first_chunk = new Chunk<value_type, allocator_type>(N);
-
-			Chunk<value_type, allocator_type>* curr_chunk = last_chunk();
-			if (curr_chunk->num_of_elements == N)
-			{
-				curr_chunk->next = new Chunk<value_type, allocator_type>(N);
-				Chunk<value_type, allocator_type>* prev = curr_chunk;
-				curr_chunk = curr_chunk->next;
-				curr_chunk->prev = prev;
-			}
-			curr_chunk->list[curr_chunk->num_of_elements++] = std::move(value);
-			list_size++;
-		};
-
-		/// @brief Appends a new element to the end of the container.
-		/// @param ...args arguments to forward to the constructor of the element
-		/// @return A reference to the inserted element.
-		template <class... Args>
-		reference emplace_back(Args&&... args) {
-			if (first_chunk == nullptr) {
-				first_chunk = new Chunk<value_type, allocator_type>(N);
-			}
-
-			Chunk<value_type, allocator_type>* curr_chunk = last_chunk();
-			if (curr_chunk->num_of_elements == N) {
-				curr_chunk->next = new Chunk<value_type, allocator_type>(N);
-				curr_chunk = curr_chunk->next;
-			}
-
-			curr_chunk->list[curr_chunk->num_of_elements++] = value_type(std::forward<Args>(args)...);;
-			list_size++;
-			return curr_chunk->list[curr_chunk->num_of_elements - 1];
-		}
-
-		/// @brief Removes the last element of the container.
-		void pop_back() {
-			if (list_size == 0) {
-				return;
-			}
-
-			list_size--;
-			Chunk<value_type, allocator_type>* curr_chunk = last_chunk();
-			curr_chunk->list[curr_chunk->num_of_elements - 1] = (value_type)nullptr;
-			curr_chunk->num_of_elements--;
-
-			if (curr_chunk->num_of_elements == 0 && first_chunk != curr_chunk) {
-				Chunk<value_type, allocator_type>* prev_chunk = curr_chunk->prev;
-				delete curr_chunk;
-				prev_chunk->next = nullptr;
-			}
-		}
-
-		/// @brief Prepends the given element value to the beginning of the container.
-		/// @param value the value of the element to prepend
-		void push_front(const T& value) {
-			insert(cbegin(), value);
-		};
-
-		/// @brief Prepends the given element value to the beginning of the container.
-		/// @param value moved value of the element to prepend
-		void push_front(T&& value) {
-			insert(cbegin(), std::move(value));
-		};
-
-		/// @brief Inserts a new element to the beginning of the container.
-		/// @param ...args arguments to forward to the constructor of the element
-		/// @return A reference to the inserted element.
-		template <class... Args>
-		reference emplace_front(Args&&... args) {
-			auto it = insert(cbegin(), value_type(std::forward<Args>(args)...));
-			return *it;
-		};
-
-		/// @brief Removes the first element of the container.
-		void pop_front() {
-			erase(cbegin());
-		};
-
-		/// @brief Resizes the container to contain count elements.
-		/// If the current size is greater than count, the container is reduced to its
-		/// first count elements. If the current size is less than count, additional
-		/// default-inserted elements are appended
-		/// @param count new size of the container
-		void resize(size_type count) {
-			if (count < 0)
-				throw std::invalid_argument("Count can not be negative");
-
-			Chunk<value_type, allocator_type>* curr_chunk = first_chunk;
-
-			while (curr_chunk != nullptr) {
-				curr_chunk->resize(count);
-				curr_chunk = curr_chunk->next;
-			}
-
-			if (count < N) {
-				list_size = 0;
-
-				curr_chunk = first_chunk;
-				while (curr_chunk != nullptr) {
-					list_size += curr_chunk->num_of_elements;
-					curr_chunk = curr_chunk->next;
-				}
-			}
-
-			chunk_size = count;
-		};
-
-		/// @brief Resizes the container to contain count elements.
-		/// If the current size is greater than count, the container is reduced to its
-		/// first count elements. If the current size is less than count, additional
-		/// copies of value are appended.
-		/// @param count new size of the container
-		/// @param value the value to initialize the new elements with
-		void resize(size_type count, const value_type& value) {
-			if (count < 0)
-				throw std::invalid_argument("Count can not be negative");
-
-			Chunk<value_type, allocator_type>* curr_chunk = first_chunk;
-
-			while (curr_chunk != nullptr) {
-				curr_chunk->resize(count, value);
-				curr_chunk = curr_chunk->next;
-			}
-
-			if (count < N) {
-				list_size = 0;
-
-				curr_chunk = first_chunk;
-				while (curr_chunk != nullptr) {
-					list_size += curr_chunk->num_of_elements;
-					curr_chunk = curr_chunk->next;
-				}
-			}
-
-			chunk_size = count;
-		};
-
-		/// @brief Exchanges the contents of the container with those of other.
-		/// Does not invoke any move, copy, or swap operations on individual elements.
-		/// All iterators and references remain valid. The past-the-end iterator is
-		/// invalidated.
-		/// @param other container to exchange the contents with
-		void swap(ChunkList<T, N, Allocator>& other) {
-			std::swap(other.first_chunk, first_chunk);
-			std::swap(other.list_size, list_size);
-		}
-
-		/// @brief Print the content of ChunkList to console.
-		void print() {
-			int chunk_num = 1;
-			Chunk<value_type, allocator_type>* curr_chunk = first_chunk;
-			while (true) {
-				std::cout << "Chunk num: " << chunk_num << std::endl;
-				for (value_type* el = curr_chunk->begin(); el != curr_chunk->end(); el++)
-					std::cout << *el << "\t";
-				std::cout << std::endl;
-
-				chunk_num++;
-
-				if (curr_chunk->next == nullptr) {
-					break;
-				}
-				else {
-					curr_chunk = curr_chunk->next;
-				}
-			}
-		}
-
-		/// COMPARISIONS
-
-		/// @brief Checks if the contents of lhs and rhs are equal
-		/// @param lhs,rhs ChunkLists whose contents to compare
-		friend bool operator==(const ChunkList<value_type, N, allocator_type>& lhs,
-			const ChunkList<value_type, N, allocator_type>& rhs) {
-			if (lhs.list_size != rhs.list_size)
-				return false;
-
-			for (int i = 0; i < lhs.list_size; i++)
-				if (lhs.at(i) != rhs.at(i))
-					return false;
-
-			return true;
-		};
-
-		/// @brief Checks if the contents of lhs and rhs are not equal
-		/// @param lhs,rhs ChunkLists whose contents to compare
-		friend bool operator!=(const ChunkList<value_type, N, allocator_type>& lhs,
-			const ChunkList<value_type, N, allocator_type>& rhs) {
-			return !operator==(lhs, rhs);
-		};
-
-		/// @brief Compares the contents of lhs and rhs lexicographically.
-		/// @param lhs,rhs ChunkLists whose contents to compare
-		friend bool operator>(const ChunkList<value_type, N, allocator_type>& lhs,
-			const ChunkList<value_type, N, allocator_type>& rhs) {
-			if (lhs.list_size != rhs.list_size) {
-				return lhs.list_size > rhs.list_size;
-			}
-			else {
-				for (int i = 0; i < lhs.list_size; i++)
-					if (lhs.at(i) <= rhs.at(i))
-						return false;
-
-				return true;
-			}
-		};
-
-		/// @brief Compares the contents of lhs and rhs lexicographically.
-		/// @param lhs,rhs ChunkLists whose contents to compare
-		friend bool operator<(const ChunkList<value_type, N, allocator_type>& lhs,
-			const ChunkList<value_type, N, allocator_type>& rhs) {
-			return !operator>(lhs, rhs);
-		};
-
-		/// @brief Compares the contents of lhs and rhs lexicographically.
-		/// @param lhs,rhs ChunkLists whose contents to compare
-		friend bool operator>=(const ChunkList<value_type, N, allocator_type>& lhs,
-			const ChunkList<value_type, N, allocator_type>& rhs) {
-			if (lhs.list_size < rhs.list_size) {
-				return false;
-			}
-			else {
-				for (int i = 0; i < lhs.list_size; i++)
-					if (lhs.at(i) < rhs.at(i))
-						return false;
-
-				return true;
-			}
-		};
-
-		/// @brief Compares the contents of lhs and rhs lexicographically.
-		/// @param lhs,rhs ChunkLists whose contents to compare
-		friend bool operator<=(const ChunkList<value_type, N, allocator_type>& lhs,
-			const ChunkList<value_type, N, allocator_type>& rhs) {
-			return !operator>=(lhs, rhs);
-		};
-
-		// operator <=> will be handy
-		std::strong_ordering operator<=>(const ChunkList& other) const {
-			if (list_size < other.list_size) {
-				return std::strong_ordering::less;
-			}
-			else if (list_size > other.list_size) {
-				return std::strong_ordering::greater;
-			}
-			else {
-				for (int i = 0; i < list_size; i++) {
-					const auto& l = at(i);
-					const auto& r = other.at(i);
-					if (l < r) {
-						return std::strong_ordering::less;
-					}
-					else if (l > r) {
-						return std::strong_ordering::greater;
-					}
-				}
-				return std::strong_ordering::equal;
-			}
-		}
-	};
-
-	/// NON-MEMBER FUNCTIONS
-
-	/// @brief  Swaps the contents of lhs and rhs.
-	/// @param lhs,rhs containers whose contents to swap
-	template <class T, int N, class Alloc>
-	void swap(ChunkList<T, N, Alloc>& lhs, ChunkList<T, N, Alloc>& rhs);
-
-	/// @brief Erases all elements that compare equal to value from the container.
-	/// @param c container from which to erase
-	/// @param value value to be removed
-	/// @return The number of erased elements.
-	template <class T, int N, class Alloc, class U>
-	typename ChunkList<T, N, Alloc>::size_type erase(ChunkList<T, N, Alloc>& c, const U& value);
-
-	/// @brief Erases all elements that compare equal to value from the container.
-	/// @param c container from which to erase
-	/// @param pred unary predicate which returns ​true if the element should be
-	/// erased.
-	/// @return The number of erased elements.
-	template <class T, int N, class Alloc, class Pred>
-	typename ChunkList<T, N, Alloc>::size_type erase_if(ChunkList<T, N, Alloc>& c, Pred pred);
-}  // namespace fefu_laboratory_two
-
+﻿#pragma once
+#include <iterator>
+#include <memory>
+#include <list>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <compare>
+#include <iostream>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <future>
+#include <thread>
+#include <vector>
+#include <concepts>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+// MSVC accepts [[no_unique_address]] but ignores it, empty members keep a
+// byte of their own there unless its own spelling is used
+#ifdef _MSC_VER
+#define CHUNKLIST_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define CHUNKLIST_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+
+namespace fefu_laboratory_two {
+	template <typename T>
+	class Allocator {
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using reference = T&;
+		using const_reference = const T&;
+
+
+		constexpr Allocator() noexcept {};
+
+		constexpr Allocator(const Allocator& other) noexcept = default;
+
+		template <class U>
+		constexpr Allocator(const Allocator<U>& other) noexcept {};
+
+		~Allocator() = default;
+
+		pointer allocate(size_type N) {
+			pointer ptr = static_cast<pointer>(::operator new(sizeof(value_type) * N));
+			if (ptr != nullptr) {
+				return ptr;
+			}
+			else {
+				throw std::bad_alloc();
+			}
+		}
+
+		void deallocate(pointer p, const size_t N) noexcept {
+			static_cast<void>(N);
+			::operator delete(p);
+		}
+	};
+
+	/// @brief Per-chunk summary that keeps nothing, the default of ChunkList.
+	///
+	/// A summary type, e.g. ZoneMap, describes the elements of one chunk and
+	/// provides:
+	///  - static constexpr bool enabled = true;
+	///  - add(value) and remove(value), called when an element is stored into
+	///    or taken out of the chunk. A summary is reset to a default-constructed
+	///    one when its chunk becomes empty instead;
+	///  - invalidate(), called when elements may be written in place, e.g.
+	///    through a non-const reference;
+	///  - stale() and rebuild(first, last): a stale summary is rebuilt from the
+	///    live elements before it is read.
+	struct NoSummary {
+		static constexpr bool enabled = false;
+	};
+
+	template <typename ValueType, typename Allocator = Allocator<ValueType>, typename Summary = NoSummary>
+	class Chunk {
+	public:
+		using size_type = std::size_t;
+		ValueType* list = nullptr;
+		Chunk* prev = nullptr;
+		Chunk* next = nullptr;
+		size_type chunk_size = 0;
+		size_type num_of_elements = 0;
+		bool owns_list = true;
+		Allocator allocator;
+		CHUNKLIST_NO_UNIQUE_ADDRESS Summary summary;
+
+		/// @brief Allocates a chunk of N default-initialized elements. Every slot of
+		/// a chunk holds a live object, the ones past num_of_elements are spare.
+		Chunk(size_type N, const Allocator& alloc = Allocator()) : allocator(alloc) {
+			list = allocate_constructed(N);
+			chunk_size = N;
+		}
+
+		/// @brief Constructs a chunk over storage it does not own, e.g. a buffer
+		/// embedded in the list object.
+		Chunk(ValueType* storage, size_type N) : list(storage), chunk_size(N), owns_list(false) {
+			std::uninitialized_default_construct_n(list, chunk_size);
+		}
+
+		Chunk(const Chunk&) = delete;
+		Chunk& operator=(const Chunk&) = delete;
+
+		~Chunk() {
+			std::destroy_n(list, chunk_size);
+			if (owns_list)
+				allocator.deallocate(list, chunk_size);
+		}
+
+		ValueType* get_data() {
+			ValueType* data = allocator.allocate(chunk_size);
+			try {
+				std::uninitialized_copy_n(list, chunk_size, data);
+			}
+			catch (...) {
+				allocator.deallocate(data, chunk_size);
+				throw;
+			}
+			return data;
+		}
+
+		ValueType* begin() {
+			return list;
+		}
+
+		ValueType* end() {
+			return list + num_of_elements;
+		}
+
+		void resize(size_type new_size) {
+			if (new_size < 0)
+				throw std::invalid_argument("New size cannot be negative");
+
+			if (new_size == chunk_size)
+				return;
+
+			size_type min_v = (num_of_elements > new_size) ? new_size : num_of_elements;
+			ValueType* new_list = allocate_constructed(new_size);
+			for (size_type i = 0; i < min_v; ++i) {
+				new_list[i] = std::move(list[i]);
+			}
+
+			if (num_of_elements > new_size)
+				num_of_elements = new_size;
+
+			std::destroy_n(list, chunk_size);
+			if (owns_list)
+				allocator.deallocate(list, chunk_size);
+			list = new_list;
+			chunk_size = new_size;
+			owns_list = true;
+			if constexpr (Summary::enabled)
+				summary.invalidate();
+		}
+
+		void resize(size_type new_size, const ValueType& value) {
+			if (new_size < 0)
+				throw std::invalid_argument("New size cannot be negative");
+
+			if (new_size == chunk_size)
+				return;
+			
+			ValueType* new_list = allocate_constructed(new_size);
+			if (new_size <= chunk_size) {
+				for (size_type i = 0; i < new_size; ++i) {
+					new_list[i] = list[i];
+				}
+			}
+			else {
+				for (size_type i = 0; i < chunk_size; ++i) {
+					new_list[i] = list[i];
+				}
+
+				for (size_type i = chunk_size; i < new_size; ++i) {
+					new_list[i] = value;
+				}
+			}
+
+
+			if (num_of_elements > new_size)
+				num_of_elements = new_size;
+
+			std::destroy_n(list, chunk_size);
+			if (owns_list)
+				allocator.deallocate(list, chunk_size);
+			list = new_list;
+			chunk_size = new_size;
+			owns_list = true;
+			num_of_elements = new_size;
+			if constexpr (Summary::enabled)
+				summary.invalidate();
+		}
+
+	private:
+		ValueType* allocate_constructed(size_type N) {
+			ValueType* storage = allocator.allocate(N);
+			try {
+				std::uninitialized_default_construct_n(storage, N);
+			}
+			catch (...) {
+				allocator.deallocate(storage, N);
+				throw;
+			}
+			return storage;
+		}
+	};
+
+	// A list without summaries keeps the chunk layout it had before them: the
+	// links, the payload pointer, the two sizes and one word shared by the
+	// ownership flag and the empty allocator
+	static_assert(sizeof(Chunk<int, Allocator<int>, NoSummary>) == 3 * sizeof(void*) + 3 * sizeof(std::size_t),
+		"NoSummary must not grow the chunks");
+
+	template<typename ValueType>
+	class ChunkListInterface {
+	public:
+		virtual ~ChunkListInterface() {}
+		virtual ValueType& at(size_t index) = 0;
+		virtual const ValueType& at(size_t index) const = 0;
+		virtual size_t size() const noexcept = 0;
+		virtual ValueType& operator[](std::ptrdiff_t n) = 0;
+		virtual const ValueType& operator[](std::ptrdiff_t n) const = 0;
+
+		/// @brief Returns the contiguous run of elements holding the element at
+		/// index, e.g. its chunk.
+		/// @param index position of an element, less than size()
+		/// @param first set to the position of the first element of the run
+		/// @param count set to the number of elements in the run
+		/// @param handle set to identify the run for step_segment
+		/// @return Pointer to the first element of the run.
+		virtual ValueType* segment(size_t index, size_t& first, size_t& count, const void*& handle) = 0;
+		virtual const ValueType* segment(size_t index, size_t& first, size_t& count, const void*& handle) const = 0;
+
+		/// @brief Returns the run after or before the one identified by handle,
+		/// which must exist, and moves handle to it. Lets an iterator walk from
+		/// run to run without searching for each from the start.
+		/// @param handle run returned by segment or step_segment
+		/// @param lookahead state the list keeps for the iterator to run ahead
+		/// of its forward steps, null when the iterator did not step forward
+		/// from run to run since it last called segment
+		/// @param forward whether to step to the following run
+		/// @param count set to the number of elements in the run
+		/// @return Pointer to the first element of the run.
+		virtual ValueType* step_segment(const void*& handle, const void*& lookahead, bool forward, size_t& count) = 0;
+		virtual const ValueType* step_segment(const void*& handle, const void*& lookahead, bool forward, size_t& count) const = 0;
+	};
+
+	/// @brief Random access iterator over a ChunkListInterface.
+	///
+	/// The iterator remembers the segment (chunk) holding the current element,
+	/// so stepping within a segment is pointer arithmetic, stepping into the
+	/// adjacent segment follows one link and only a jump further away asks the
+	/// list where it is. The past-the-end iterator is
+	/// an ordinary iterator at position size(), so it can be decremented and
+	/// compared with any other iterator of the list.
+	/// @tparam ValueType type of the elements
+	/// @tparam Const whether the elements are accessed read-only
+	template <typename ValueType, bool Const>
+	class ChunkList_basic_iterator {
+		using list_pointer = std::conditional_t<Const, const ChunkListInterface<ValueType>*, ChunkListInterface<ValueType>*>;
+	public:
+		using iterator_concept = std::random_access_iterator_tag;
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = ValueType;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<Const, const ValueType*, ValueType*>;
+		using reference = std::conditional_t<Const, const ValueType&, ValueType&>;
+
+		constexpr ChunkList_basic_iterator() noexcept = default;
+
+		/// @param list list to iterate over
+		/// @param index position of the element, or list->size() for the
+		/// past-the-end iterator
+		ChunkList_basic_iterator(list_pointer list, difference_type index) : list(list), elem_index(index) {
+			load();
+		};
+
+		/// @brief Converts an iterator to a const iterator.
+		template <bool OtherConst>
+			requires (Const && !OtherConst)
+		ChunkList_basic_iterator(const ChunkList_basic_iterator<ValueType, OtherConst>& other) noexcept :
+			list(other.list),
+			elem_index(other.elem_index),
+			current_value(other.current_value),
+			segment_begin(other.segment_begin),
+			segment_end(other.segment_end),
+			segment_handle(other.segment_handle),
+			lookahead_handle(other.lookahead_handle)
+		{
+		};
+
+		difference_type get_index() const noexcept { return elem_index; };
+
+		reference operator*() const { return *current_value; };
+		pointer operator->() const { return current_value; };
+		reference operator[](difference_type n) const { return *(*this + n); };
+
+		ChunkList_basic_iterator& operator++() {
+			elem_index++;
+			if (++current_value == segment_end)
+				step(true);
+			return *this;
+		};
+
+		ChunkList_basic_iterator operator++(int) {
+			ChunkList_basic_iterator old = *this;
+			++*this;
+			return old;
+		};
+
+		ChunkList_basic_iterator& operator--() {
+			elem_index--;
+			if (current_value == segment_begin) {
+				if (segment_handle != nullptr)
+					step(false);
+				else
+					load();
+			}
+			else {
+				current_value--;
+			}
+			return *this;
+		};
+
+		ChunkList_basic_iterator operator--(int) {
+			ChunkList_basic_iterator old = *this;
+			--*this;
+			return old;
+		};
+
+		ChunkList_basic_iterator& operator+=(difference_type n) {
+			elem_index += n;
+			difference_type offset = (current_value - segment_begin) + n;
+			if (current_value != nullptr && offset >= 0 && offset < segment_end - segment_begin)
+				current_value = segment_begin + offset;
+			else
+				load();
+			return *this;
+		};
+
+		ChunkList_basic_iterator& operator-=(difference_type n) { return *this += -n; };
+
+		friend ChunkList_basic_iterator operator+(ChunkList_basic_iterator it, difference_type n) { return it += n; };
+		friend ChunkList_basic_iterator operator+(difference_type n, ChunkList_basic_iterator it) { return it += n; };
+		friend ChunkList_basic_iterator operator-(ChunkList_basic_iterator it, difference_type n) { return it -= n; };
+
+		friend difference_type operator-(const ChunkList_basic_iterator& lhs, const ChunkList_basic_iterator& rhs) noexcept {
+			return lhs.elem_index - rhs.elem_index;
+		};
+
+		friend bool operator==(const ChunkList_basic_iterator& lhs, const ChunkList_basic_iterator& rhs) noexcept {
+			return lhs.elem_index == rhs.elem_index;
+		};
+
+		friend std::strong_ordering operator<=>(const ChunkList_basic_iterator& lhs, const ChunkList_basic_iterator& rhs) noexcept {
+			return lhs.elem_index <=> rhs.elem_index;
+		};
+
+	private:
+		template <typename, bool>
+		friend class ChunkList_basic_iterator;
+
+		/// @brief Finds the segment holding the element at elem_index. Positions
+		/// outside the list, e.g. past-the-end, hold no segment.
+		void load() {
+			if (!in_list()) {
+				unload();
+				return;
+			}
+			std::size_t first, count;
+			segment_begin = list->segment(static_cast<std::size_t>(elem_index), first, count, segment_handle);
+			lookahead_handle = nullptr;
+			segment_end = segment_begin + count;
+			current_value = segment_begin + (static_cast<std::size_t>(elem_index) - first);
+		}
+
+		/// @brief Moves to the segment adjacent to the current one after
+		/// elem_index stepped out of it.
+		void step(bool forward) {
+			if (!in_list()) {
+				unload();
+				return;
+			}
+			std::size_t count;
+			segment_begin = list->step_segment(segment_handle, lookahead_handle, forward, count);
+			segment_end = segment_begin + count;
+			current_value = forward ? segment_begin : segment_end - 1;
+		}
+
+		bool in_list() const noexcept {
+			return list != nullptr && elem_index >= 0 && static_cast<std::size_t>(elem_index) < list->size();
+		}
+
+		void unload() noexcept {
+			current_value = segment_begin = segment_end = nullptr;
+			segment_handle = nullptr;
+			lookahead_handle = nullptr;
+		}
+
+		list_pointer list = nullptr;
+		difference_type elem_index = 0;
+		pointer current_value = nullptr;
+		pointer segment_begin = nullptr;
+		pointer segment_end = nullptr;
+		const void* segment_handle = nullptr;
+		const void* lookahead_handle = nullptr;
+	};
+
+	template <typename ValueType>
+	using ChunkList_iterator = ChunkList_basic_iterator<ValueType, false>;
+
+	template <typename ValueType>
+	using ChunkList_const_iterator = ChunkList_basic_iterator<ValueType, true>;
+
+	/// CHUNK SIZE POLICIES
+	///
+	/// A size policy decides the capacity of every chunk from its ordinal (the
+	/// position of the chunk in the chain) and maps an element index to the
+	/// chunk holding it. Every chunk except the last one is kept full, so the
+	/// mapping is pure arithmetic for every policy.
+
+	/// @brief Chunk payload size used to derive the default chunk capacity.
+	inline constexpr std::size_t default_chunk_bytes = 4096;
+
+	/// @brief Size of a cache line, for chunk payloads sized in cache lines.
+	inline constexpr std::size_t cache_line_size = 64;
+
+	/// @brief How many chunks ahead of a sequential walk the header and the
+	/// payload are prefetched, 0 to turn prefetching off. Further ahead hides
+	/// more memory latency but may evict lines that are still needed; tune it
+	/// for the machine.
+	inline std::atomic<std::size_t> prefetch_distance{ 2 };
+
+	/// @brief Hints the processor to bring the cache line holding address into
+	/// the cache. Does nothing on compilers without a prefetch intrinsic.
+	inline void prefetch(const void* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+		static_cast<void>(address);
+#endif
+	}
+
+	/// @brief Cursor running prefetch_distance chunks ahead of a walk along the
+	/// next links. Each step of the walk moves it one link, then it prefetches
+	/// the payload of the chunk it reached and the header of the one after,
+	/// so the header it reads at the next step is already on its way.
+	/// prefetch_distance is read once, when the cursor starts.
+	/// @tparam ChunkType chunk with list and next members
+	/// @tparam PayloadBytes bytes prefetched from the start of a payload, whatever
+	/// its fill; the hardware prefetcher picks up the rest of a sequential scan
+	template <class ChunkType, std::size_t PayloadBytes>
+	class ChunkPrefetcher {
+	public:
+		ChunkPrefetcher() = default;
+
+		/// @brief Starts the cursor prefetch_distance links after chunk, where the
+		/// walk starts. The links up to there are followed once.
+		explicit ChunkPrefetcher(const ChunkType* chunk) noexcept {
+			std::size_t distance = prefetch_distance.load(std::memory_order_relaxed);
+			if (distance == 0 || chunk == nullptr)
+				return;
+			for (ahead = chunk; distance > 0 && ahead != nullptr; distance--)
+				ahead = ahead->next;
+			issue();
+		}
+
+		/// @brief Follows the walk to the next chunk.
+		void step() noexcept {
+			if (ahead == nullptr)
+				return;
+			ahead = ahead->next;
+			issue();
+		}
+
+		/// @brief Steps the cursor kept in handle for a walk that reached chunk,
+		/// starting it there if handle is null.
+		static void step(const void*& handle, const ChunkType* chunk) noexcept {
+			ChunkPrefetcher cursor;
+			if (handle == nullptr)
+				cursor = ChunkPrefetcher(chunk);
+			else if (handle != &stopped) {
+				cursor.ahead = static_cast<const ChunkType*>(handle);
+				cursor.step();
+			}
+			handle = cursor.ahead != nullptr ? static_cast<const void*>(cursor.ahead) : &stopped;
+		}
+
+	private:
+		void issue() const noexcept {
+			if (ahead == nullptr)
+				return;
+			const char* payload = reinterpret_cast<const char*>(ahead->list);
+			for (std::size_t line = 0; line < PayloadBytes; line += cache_line_size)
+				prefetch(payload + line);
+			if (ahead->next != nullptr)
+				prefetch(ahead->next);
+		}
+
+		/// @brief Handle of a cursor that ran off the chain or is turned off.
+		static inline const char stopped = 0;
+
+		const ChunkType* ahead = nullptr;
+	};
+
+	/// @brief Returns the largest power-of-two number of T that fits in Bytes,
+	/// so that index math on the chunks compiles to shifts and masks.
+	/// @tparam Bytes target payload size of a chunk, e.g. default_chunk_bytes or
+	/// a multiple of cache_line_size
+	template <typename T, std::size_t Bytes = default_chunk_bytes>
+	constexpr std::size_t default_chunk_size() noexcept {
+		return sizeof(T) >= Bytes ? 1 : std::bit_floor(Bytes / sizeof(T));
+	}
+
+	/// @brief True for element types whose values are equal exactly when their
+	/// bytes are, so runs of them are compared with memcmp and hashed as bytes.
+	template <typename T>
+	inline constexpr bool bitwise_comparable_v = std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+
+	/// @brief 64-bit hash of a sequence of bytes fed in pieces, a word at a
+	/// time. The result depends on the bytes only, not on how they are split,
+	/// so lists whose chunks differ in size hash the same.
+	class StreamHash {
+	public:
+		void update(const void* data, std::size_t bytes) noexcept {
+			const unsigned char* p = static_cast<const unsigned char*>(data);
+			total += bytes;
+			if (pending_bytes > 0) {
+				std::size_t take = std::min(sizeof(pending) - pending_bytes, bytes);
+				std::memcpy(reinterpret_cast<unsigned char*>(&pending) + pending_bytes, p, take);
+				pending_bytes += take;
+				p += take;
+				bytes -= take;
+				if (pending_bytes < sizeof(pending))
+					return;
+				state = step(state, pending);
+				pending = 0;
+				pending_bytes = 0;
+			}
+			for (; bytes >= sizeof(std::uint64_t); p += sizeof(std::uint64_t), bytes -= sizeof(std::uint64_t)) {
+				std::uint64_t word;
+				std::memcpy(&word, p, sizeof(word));
+				state = step(state, word);
+			}
+			std::memcpy(&pending, p, bytes);
+			pending_bytes = bytes;
+		}
+
+		void update_word(std::uint64_t word) noexcept {
+			update(&word, sizeof(word));
+		}
+
+		/// @brief Feeds the elements [first, last): as bytes for integers, enums
+		/// and pointers hashed by std::hash, and through hasher otherwise.
+		template <typename T, class Hash = std::hash<T>>
+		void update_elements(const T* first, const T* last, const Hash& hasher = Hash()) {
+			if constexpr (bitwise_comparable_v<T> && std::is_same_v<Hash, std::hash<T>>) {
+				update(first, static_cast<std::size_t>(last - first) * sizeof(T));
+			}
+			else {
+				for (; first != last; first++)
+					update_word(static_cast<std::uint64_t>(hasher(*first)));
+			}
+		}
+
+		std::uint64_t digest() const noexcept {
+			std::uint64_t h = pending_bytes > 0 ? step(state, pending) : state;
+			h ^= total;
+			// splitmix64 finalizer
+			h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+			h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+			return h ^ (h >> 31);
+		}
+
+	private:
+		static std::uint64_t step(std::uint64_t state, std::uint64_t word) noexcept {
+			return std::rotl(state ^ (word * 0x9e3779b97f4a7c15ull), 27) * 0xff51afd7ed558ccdull;
+		}
+
+		std::uint64_t state = 0;
+		std::uint64_t pending = 0;
+		std::size_t pending_bytes = 0;
+		std::uint64_t total = 0;
+	};
+
+	/// @brief Every chunk holds exactly N elements. A power-of-two N is located
+	/// with a shift and a mask.
+	/// @tparam N capacity of a chunk
+	template <std::size_t N>
+	class FixedChunkSize {
+		static_assert(N > 0, "Chunk size must be positive");
+	public:
+		using size_type = std::size_t;
+
+		static constexpr bool power_of_two = std::has_single_bit(N);
+		static constexpr unsigned shift = std::countr_zero(N);
+
+		/// @brief Every chunk has the same capacity.
+		static constexpr bool uniform = true;
+
+		/// @brief Returns the capacity of the chunk with the given ordinal.
+		constexpr size_type capacity(size_type) const noexcept { return N; }
+
+		/// @brief Returns the index of the first element of the chunk with the
+		/// given ordinal.
+		constexpr size_type first_index(size_type ordinal) const noexcept {
+			if constexpr (power_of_two)
+				return ordinal << shift;
+			else
+				return ordinal * N;
+		}
+
+		/// @brief Splits pos into the ordinal of the chunk holding it and the
+		/// offset inside that chunk.
+		constexpr void locate(size_type pos, size_type& ordinal, size_type& offset) const noexcept {
+			if constexpr (power_of_two) {
+				ordinal = pos >> shift;
+				offset = pos & (N - 1);
+			}
+			else {
+				ordinal = pos / N;
+				offset = pos % N;
+			}
+		}
+	};
+
+	/// @brief Every chunk holds the same number of elements, chosen when the
+	/// container is constructed. Power-of-two sizes are located with a shift and
+	/// a mask instead of a division.
+	/// @tparam N capacity of a chunk when no size is given
+	template <std::size_t N>
+	class RuntimeChunkSize {
+	public:
+		using size_type = std::size_t;
+
+		constexpr RuntimeChunkSize() : RuntimeChunkSize(N) {};
+
+		/// @param chunk_size capacity of every chunk
+		/// @throw std::invalid_argument if chunk_size is zero
+		constexpr explicit RuntimeChunkSize(size_type chunk_size) : chunk_size(chunk_size) {
+			if (chunk_size == 0)
+				throw std::invalid_argument("Chunk size must be positive");
+			if (std::has_single_bit(chunk_size)) {
+				shift = std::countr_zero(chunk_size);
+				power_of_two = true;
+			}
+		};
+
+		static constexpr bool uniform = true;
+
+		constexpr size_type capacity(size_type) const noexcept { return chunk_size; }
+
+		constexpr size_type first_index(size_type ordinal) const noexcept { return ordinal * chunk_size; }
+
+		constexpr void locate(size_type pos, size_type& ordinal, size_type& offset) const noexcept {
+			if (power_of_two) {
+				ordinal = pos >> shift;
+				offset = pos & (chunk_size - 1);
+			}
+			else {
+				ordinal = pos / chunk_size;
+				offset = pos % chunk_size;
+			}
+		}
+
+	private:
+		size_type chunk_size;
+		unsigned shift = 0;
+		bool power_of_two = false;
+	};
+
+	/// @brief The first chunk holds N elements and every following chunk holds
+	/// twice as many as the previous one, until the capacity reaches Cap.
+	/// Small lists stay small while huge lists are made of few large chunks.
+	/// @tparam N capacity of the first chunk
+	/// @tparam Cap largest chunk capacity, must be N times a power of two
+	template <std::size_t N, std::size_t Cap = N * 64>
+	class GeometricChunkSize {
+		static_assert(N > 0, "Chunk size must be positive");
+		static_assert(Cap % N == 0 && std::has_single_bit(Cap / N),
+			"Cap must be N times a power of two");
+
+		using first_size = FixedChunkSize<N>;
+		using capped_size = FixedChunkSize<Cap>;
+	public:
+		using size_type = std::size_t;
+
+		/// @brief Number of growing chunks before the capacity reaches Cap.
+		static constexpr size_type growth_steps = std::countr_zero(Cap / N);
+
+		/// @brief Number of elements held by the growing chunks.
+		static constexpr size_type ramp_size = N * ((size_type(1) << growth_steps) - 1);
+
+		constexpr size_type capacity(size_type ordinal) const noexcept {
+			return ordinal < growth_steps ? N << ordinal : Cap;
+		}
+
+		constexpr size_type first_index(size_type ordinal) const noexcept {
+			if (ordinal < growth_steps)
+				return N * ((size_type(1) << ordinal) - 1);
+			return ramp_size + (ordinal - growth_steps) * Cap;
+		}
+
+		constexpr void locate(size_type pos, size_type& ordinal, size_type& offset) const noexcept {
+			if (pos < ramp_size) {
+				// Chunk k starts at N * (2^k - 1), so k is the position of the
+				// highest set bit of pos / N + 1
+				size_type first_ordinal, first_offset;
+				first_size().locate(pos, first_ordinal, first_offset);
+				ordinal = std::bit_width(first_ordinal + 1) - 1;
+				offset = pos - first_size().first_index((size_type(1) << ordinal) - 1);
+			}
+			else {
+				capped_size().locate(pos - ramp_size, ordinal, offset);
+				ordinal += growth_steps;
+			}
+		}
+	};
+
+	/// @brief First chunk of a ChunkList embedded in the list object itself.
+	/// @tparam InlineN number of elements stored without heap allocation
+	template <typename T, typename Allocator, std::size_t InlineN, typename Summary = NoSummary>
+	struct InlineChunk {
+		Chunk<T, Allocator, Summary> chunk;
+		alignas(T) unsigned char storage[InlineN * sizeof(T)];
+
+		InlineChunk() : chunk(reinterpret_cast<T*>(storage), InlineN) {}
+
+		InlineChunk(const InlineChunk&) : InlineChunk() {}
+		InlineChunk& operator=(const InlineChunk&) { return *this; }
+	};
+
+	template <typename T, typename Allocator, typename Summary>
+	struct InlineChunk<T, Allocator, 0, Summary> {
+	};
+
+#ifdef CHUNKLIST_ENABLE_STATS
+	/// @brief True when lists count the events reported by ChunkList::stats().
+	inline constexpr bool stats_enabled = true;
+#else
+	inline constexpr bool stats_enabled = false;
+#endif
+
+	/// @brief Events counted by a ChunkList when CHUNKLIST_ENABLE_STATS is
+	/// defined. Counters follow the list object, not the chunks it holds.
+	struct ChunkListCounters {
+		std::size_t chunks_allocated = 0;
+		std::size_t chunks_freed = 0;
+		/// @brief Links followed to reach a chunk by position.
+		std::size_t lookup_hops = 0;
+		/// @brief Elements moved to open or close a gap by insert and erase.
+		std::size_t elements_moved = 0;
+	};
+
+	/// @brief Snapshot returned by ChunkList::stats().
+	struct ChunkListStats : ChunkListCounters {
+		static constexpr std::size_t occupancy_buckets = 10;
+
+		std::size_t chunks = 0;
+		std::size_t elements = 0;
+		std::size_t capacity = 0;
+		/// @brief Bytes of element slots past the last element of each chunk.
+		std::size_t slack_bytes = 0;
+		/// @brief elements / capacity, 1 for a list without chunks.
+		double fill_factor = 1.0;
+		/// @brief Number of chunks by fill: bucket i counts the chunks holding
+		/// [i, i + 1) tenths of their capacity, the last bucket the full ones too.
+		std::array<std::size_t, occupancy_buckets> occupancy{};
+	};
+
+	/// @tparam T type of the elements
+	/// @tparam N capacity of a chunk, or the first chunk size of SizePolicy
+	/// @tparam SizePolicy chunk size policy, see FixedChunkSize,
+	/// RuntimeChunkSize and GeometricChunkSize
+	/// @tparam InlineN capacity of a first chunk embedded in the list object.
+	/// Lists of at most InlineN elements do not touch the heap; longer ones
+	/// spill into chunks sized by SizePolicy.
+	/// @tparam Summary per-chunk summary maintained by the modifiers and used
+	/// by the range queries to skip chunks, see NoSummary and ZoneMap
+	template <typename T, std::size_t N = default_chunk_size<T>(), typename Allocator = Allocator<T>,
+		typename SizePolicy = FixedChunkSize<N>, std::size_t InlineN = 0, typename Summary = NoSummary>
+	class ChunkList : public ChunkListInterface<T> {
+	protected:
+		using chunk_type = Chunk<T, Allocator, Summary>;
+
+		/// @brief Prefetches up to four cache lines of a payload, or the whole
+		/// payload of a chunk of the first size.
+		using prefetcher = ChunkPrefetcher<chunk_type,
+			std::max(cache_line_size, std::min(4 * cache_line_size, N * sizeof(T)))>;
+
+		/// @brief Number of chunks preceding the ones sized by the policy.
+		static constexpr std::size_t inline_chunks = InlineN > 0 ? 1 : 0;
+
+		chunk_type* first_chunk = nullptr;
+		chunk_type* tail_chunk = nullptr;
+		std::size_t list_size = 0;
+		std::size_t num_of_chunks = 0;
+		SizePolicy size_policy;
+		Allocator allocator;
+		InlineChunk<T, Allocator, InlineN, Summary> inline_chunk;
+
+		struct no_counters {};
+		CHUNKLIST_NO_UNIQUE_ADDRESS mutable std::conditional_t<stats_enabled, ChunkListCounters, no_counters> counters;
+	public:
+
+		using value_type = T;
+		using allocator_type = Allocator;
+		using size_policy_type = SizePolicy;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using pointer = typename std::allocator_traits<Allocator>::pointer;
+		using const_pointer = typename std::allocator_traits<Allocator>::const_pointer;
+		using iterator = ChunkList_iterator<value_type>;
+		using const_iterator = ChunkList_const_iterator<value_type>;
+
+		/// @brief Default constructor. Constructs an empty container with a
+		/// default-constructed allocator.
+		ChunkList() {};
+
+		/// @brief Constructs an empty container with the given allocator
+		/// @param alloc allocator to use for all memory allocations of this container
+		/// s
+		/*explicit ChunkList(const Allocator& alloc);*/
+
+		/// @brief Constructs an empty container whose chunks are sized by the given
+		/// policy.
+		/// @param policy chunk size policy, e.g. RuntimeChunkSize<N>(size)
+		/// @param alloc allocator to use for all memory allocations of this container
+		explicit ChunkList(const SizePolicy& policy, const Allocator& alloc = Allocator())
+			: size_policy(policy), allocator(alloc)
+		{
+		};
+
+		/// @brief Constructs the container with count copies of elements with value
+		/// and with the given allocator
+		/// @param count the size of the container
+		/// @param value the value to initialize elements of the container with
+		/// @param alloc allocator to use for all memory allocations of this container
+		ChunkList(size_type count, const T& value = T(), const Allocator& alloc = Allocator())
+			: allocator(alloc)
+		{
+			for (size_type i = 0; i < count; i++)
+				push_back(value);
+		};
+
+		/// @brief Constructs the container with count default-inserted instances of
+		/// T. No copies are made.
+		/// @param count the size of the container
+		/// @param alloc allocator to use for all memory allocations of this container
+		explicit ChunkList(size_type count, const Allocator& alloc = Allocator())
+			: allocator(alloc)
+		{
+			for (size_type i = 0; i < count; i++)
+				emplace_back();
+		};
+
+		/// @brief Constructs the container with the contents of the range [first,
+		/// last).
+		/// @tparam InputIt Input Iterator
+		/// @param first, last 	the range to copy the elements from
+		/// @param alloc allocator to use for all memory allocations of this container
+		template <class InputIt>
+		ChunkList(InputIt first, InputIt last, const Allocator& alloc = Allocator())
+			: allocator(alloc)
+		{
+			for (auto it = first; it != last; ++it)
+				push_back(*it);
+		};
+
+		/// @brief Copy constructor. Constructs the container with the copy of the
+		/// contents of other.
+		/// @param other another container to be used as source to initialize the
+		/// elements of the container with
+		ChunkList(const ChunkList& other)
+			: size_policy(other.size_policy), allocator(other.allocator)
+		{
+			append_all(other);
+		};
+
+		/// @brief Constructs the container with the copy of the contents of other,
+		/// using alloc as the allocator.
+		/// @param other another container to be used as source to initialize the
+		/// elements of the container with
+		/// @param alloc allocator to use for all memory allocations of this container
+		ChunkList(const ChunkList& other, const Allocator& alloc)
+			: size_policy(other.size_policy), allocator(alloc)
+		{
+			append_all(other);
+		};
+
+		/**
+		 * @brief Move constructor.
+		 *
+		 * Constructs the container with the contents of other using move semantics.
+		 * Allocator is obtained by move-construction from the allocator belonging to
+		 * other.
+		 *
+		 * @param other another container to be used as source to initialize the
+		 * elements of the container with
+		 */
+		ChunkList(ChunkList&& other)
+			: size_policy(other.size_policy), allocator(std::move(other.allocator))
+		{
+			steal(other);
+		};
+
+		/**
+		 * @brief Allocator-extended move constructor.
+		 * Using alloc as the allocator for the new container, moving the contents
+		 * from other; if alloc != other.get_allocator(), this results in an
+		 * element-wise move.
+		 *
+		 * @param other another container to be used as source to initialize the
+		 * elements of the container with
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		ChunkList(ChunkList&& other, const Allocator& alloc) : ChunkList(std::move(other)) {
+			allocator = alloc;
+			chunk_type* current_chunk = first_chunk;
+			while (current_chunk != nullptr) {
+				current_chunk->allocator = alloc;
+				current_chunk = current_chunk->next;
+			}
+		};
+
+		/// @brief Constructs the container with the contents of the initializer list
+		/// init.
+		/// @param init initializer list to initialize the elements of the container
+		/// with
+		/// @param alloc allocator to use for all memory allocations of this container
+		ChunkList(std::initializer_list<T> init, const Allocator& alloc = Allocator())
+			: allocator(alloc)
+		{
+			for (const auto& value : init)
+				push_back(value);
+		}
+
+		/// @brief Destructs the ChunkList.
+		~ChunkList() {
+			clear();
+		};
+
+		/// @brief Copy assignment operator. Replaces the contents with a copy of the
+		/// contents of other.
+		/// @param other another container to use as data source
+		/// @return *this
+		ChunkList& operator=(const ChunkList& other) {
+			if (this != &other) {
+				ChunkList copy(other);
+				swap(copy);
+			}
+			return (*this);
+		};
+
+		/**
+		 * Move assignment operator.
+		 *
+		 * Replaces the contents with those of other using move semantics
+		 * (i.e. the data in other is moved from other into this container).
+		 * other is in a valid but unspecified state afterwards.
+		 *
+		 * @param other another container to use as data source
+		 * @return *this
+		 */
+		ChunkList& operator=(ChunkList&& other) {
+			if (this != &other) {
+				clear();
+				size_policy = other.size_policy;
+				allocator = other.allocator;
+				steal(other);
+			}
+			return *this;
+		};
+
+		/// @brief Replaces the contents with those identified by initializer list
+		/// ilist.
+		/// @param ilist
+		/// @return this
+		ChunkList& operator=(std::initializer_list<T> ilist) {
+			clear();
+			for (const auto& elem : ilist)
+				push_back(elem);
+			return *this;
+		}
+
+		/// @brief Replaces the contents with count copies of value
+		/// @param count
+		/// @param value
+		void assign(size_type count, const T& value) {
+			if (count < 0)
+				throw std::out_of_range("Count argument must be non-negative");
+			clear();
+			for (size_type i = 0; i < count; i++)
+				push_back(value);
+		};
+
+		/// @brief Replaces the contents with copies of those in the range [first,
+		/// last).
+		/// @tparam InputIt
+		/// @param first
+		/// @param last
+		template <class InputIt>
+		void assignIt(InputIt first, InputIt last) {
+			clear();
+			for (InputIt it = first; it != last; ++it) {
+				push_back(*it);
+			}
+		}
+
+		/// @brief Replaces the contents with the elements from the initializer list
+		/// ilis
+		/// @param ilist
+		void assign(std::initializer_list<T> ilist) {
+			clear();
+			for (const auto& value : ilist) {
+				push_back(value);
+			}
+		}
+
+		/// @brief Returns the allocator associated with the container.
+		/// @return The associated allocator.
+		allocator_type get_allocator() const noexcept {
+			return allocator;
+		};
+
+		/// @brief Returns the chunk size policy of the container.
+		/// @return The associated size policy.
+		const size_policy_type& get_size_policy() const noexcept {
+			return size_policy;
+		};
+
+		/// @brief Returns the first chunk, or nullptr if no chunk is allocated.
+		/// Chunks are linked by next; the elements of a chunk are
+		/// [list, list + num_of_elements).
+		chunk_type* front_chunk() const {
+			return first_chunk;
+		}
+
+		chunk_type* last_chunk() const {
+			return tail_chunk;
+		}
+
+		/// ELEMENT ACCESS
+
+		/// @brief Returns a reference to the element at specified location pos, with
+		/// bounds checking. If pos is not within the range of the container, an
+		/// exception of type std::out_of_range is thrown.
+		/// @param pos position of the element to return
+		/// @return Reference to the requested element.
+		/// @throw std::out_of_range
+		reference at(size_type pos) {
+			if (pos >= size()) {
+				throw std::out_of_range("Out of range");
+			}
+			chunk_type* curr_chunk;
+			size_type elemnt_index;
+			locate(pos, curr_chunk, elemnt_index);
+			touch(curr_chunk);
+			return curr_chunk->list[elemnt_index];
+		};
+
+		/// @brief Returns a const reference to the element at specified location pos,
+		/// with bounds checking. If pos is not within the range of the container, an
+		/// exception of type std::out_of_range is thrown.
+		/// @param pos position of the element to return
+		/// @return Const Reference to the requested element.
+		/// @throw std::out_of_range
+		const_reference at(size_type pos) const {
+			if (pos >= size()) {
+				throw std::out_of_range("Out of range");
+			}
+			chunk_type* curr_chunk;
+			size_type elemnt_index;
+			locate(pos, curr_chunk, elemnt_index);
+			return curr_chunk->list[elemnt_index];
+		};
+
+		/// @brief Returns a reference to the element at specified location pos. No
+		/// bounds checking is performed.
+		/// @param pos position of the element to return
+		/// @return Reference to the requested element.
+		reference operator[](difference_type pos) {
+			chunk_type* curr_chunk;
+			size_type elemnt_index;
+			locate(pos, curr_chunk, elemnt_index);
+			touch(curr_chunk);
+			return curr_chunk->list[elemnt_index];
+		};
+
+		/// @brief Returns a const reference to the element at specified location pos.
+		/// No bounds checking is performed.
+		/// @param pos position of the element to return
+		/// @return Const Reference to the requested element.
+		const_reference operator[](difference_type pos) const {
+			chunk_type* curr_chunk;
+			size_type elemnt_index;
+			locate(pos, curr_chunk, elemnt_index);
+			return curr_chunk->list[elemnt_index];
+		};
+
+		/// @brief Returns the elements of the chunk holding the element at index.
+		/// Used by the iterators to step through a chunk with a pointer.
+		/// @param index position of an element, less than size()
+		/// @param first set to the position of the first element of the chunk
+		/// @param count set to the number of elements in the chunk
+		/// @return Pointer to the first element of the chunk.
+		pointer segment(size_type index, size_type& first, size_type& count, const void*& handle) override {
+			chunk_type* curr_chunk;
+			size_type offset;
+			locate(index, curr_chunk, offset);
+			touch(curr_chunk);
+			first = index - offset;
+			count = curr_chunk->num_of_elements;
+			handle = curr_chunk;
+			return curr_chunk->list;
+		};
+
+		const_pointer segment(size_type index, size_type& first, size_type& count, const void*& handle) const override {
+			chunk_type* curr_chunk;
+			size_type offset;
+			locate(index, curr_chunk, offset);
+			first = index - offset;
+			count = curr_chunk->num_of_elements;
+			handle = curr_chunk;
+			return curr_chunk->list;
+		};
+
+		/// @brief Steps to the chunk after or before the one behind handle.
+		/// Forward steps keep a ChunkPrefetcher running ahead in lookahead, see
+		/// prefetch_distance.
+		pointer step_segment(const void*& handle, const void*& lookahead, bool forward, size_type& count) override {
+			chunk_type* chunk = adjacent_chunk(handle, lookahead, forward);
+			touch(chunk);
+			count = chunk->num_of_elements;
+			return chunk->list;
+		};
+
+		const_pointer step_segment(const void*& handle, const void*& lookahead, bool forward, size_type& count) const override {
+			chunk_type* chunk = adjacent_chunk(handle, lookahead, forward);
+			count = chunk->num_of_elements;
+			return chunk->list;
+		};
+
+		/// @brief Returns a reference to the first element in the container.
+		/// Calling front on an empty container is undefined.
+		/// @return Reference to the first element
+		reference front() {
+			if (list_size == 0)
+				throw std::logic_error("Empty");
+
+			touch(first_chunk);
+			return first_chunk->list[0];
+		};
+
+		/// @brief Returns a const reference to the first element in the container.
+		/// Calling front on an empty container is undefined.
+		/// @return Const reference to the first element
+		const_reference front() const {
+			if (list_size == 0)
+				throw std::logic_error("Empty");
+
+			return first_chunk->list[0];
+		};
+
+		/// @brief Returns a reference to the last element in the container.
+		/// Calling back on an empty container causes undefined behavior.
+		/// @return Reference to the last element.
+		reference back() {
+			if (list_size == 0)
+				throw std::logic_error("Empty");
+
+			chunk_type* curr_chunk = last_chunk();
+			touch(curr_chunk);
+
+			return curr_chunk->list[curr_chunk->num_of_elements - 1];
+		};
+
+		/// @brief Returns a const reference to the last element in the container.
+		/// Calling back on an empty container causes undefined behavior.
+		/// @return Const Reference to the last element.
+		const_reference back() const {
+			if(list_size == 0)
+				throw std::logic_error("Empty");
+
+			chunk_type* curr_chunk = last_chunk();
+
+			return curr_chunk->list[curr_chunk->num_of_elements - 1];
+		};
+
+		/// ITERATORS
+
+		/// @brief Returns an iterator to the first element of the ChunkList.
+		/// If the ChunkList is empty, the returned iterator will be equal to end().
+		/// @return Iterator to the first element.
+		iterator begin() noexcept {
+			return iterator(this, 0);
+		};
+
+		/// @brief Returns an iterator to the first element of the ChunkList.
+		/// If the ChunkList is empty, the returned iterator will be equal to end().
+		/// @return Iterator to the first element.
+		const_iterator begin() const noexcept {
+			return const_iterator(this, 0);
+		};
+
+		/// @brief Same to begin()
+		const_iterator cbegin() const noexcept { return begin(); };
+
+		/// @brief Returns an iterator to the element following the last element of
+		/// the ChunkList. This element acts as a placeholder; attempting to access it
+		/// results in undefined behavior. It can be decremented to the last element.
+		/// @return Iterator to the element following the last element.
+		iterator end() noexcept {
+			return iterator(this, list_size);
+		};
+
+		/// @brief Returns an constant iterator to the element following the last
+		/// element of the ChunkList. This element acts as a placeholder; attempting to
+		/// access it results in undefined behavior.
+		/// @return Constant Iterator to the element following the last element.
+		const_iterator end() const noexcept {
+			return const_iterator(this, list_size);
+		};
+
+		/// @brief Same to end()
+		const_iterator cend() const noexcept { return end(); };
+
+		/// SEGMENTS
+
+		/// @brief View of the chunks of a ChunkList, each seen as a std::span of
+		/// its elements. Valid until the list is modified.
+		/// @tparam Element value_type or const value_type
+		template <class Element>
+		class segment_view : public std::ranges::view_interface<segment_view<Element>> {
+		public:
+			class iterator {
+			public:
+				using value_type = std::span<Element>;
+				using difference_type = std::ptrdiff_t;
+
+				iterator() = default;
+
+				explicit iterator(chunk_type* chunk) noexcept : chunk(chunk), ahead(chunk) {}
+
+				value_type operator*() const noexcept { return value_type(chunk->list, chunk->num_of_elements); }
+
+				iterator& operator++() noexcept {
+					chunk = chunk->next;
+					ahead.step();
+					return *this;
+				}
+
+				iterator operator++(int) noexcept {
+					iterator old = *this;
+					++*this;
+					return old;
+				}
+
+				friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept { return lhs.chunk == rhs.chunk; }
+
+			private:
+				chunk_type* chunk = nullptr;
+				prefetcher ahead;
+			};
+
+			segment_view() = default;
+
+			explicit segment_view(chunk_type* first) noexcept : first(first) {}
+
+			iterator begin() const noexcept { return iterator(first); }
+			iterator end() const noexcept { return iterator(); }
+
+		private:
+			chunk_type* first = nullptr;
+		};
+
+		/// @brief Returns the chunks as a range of spans, for loops and view
+		/// pipelines that run over contiguous storage a chunk at a time, see
+		/// for_each_segmented. Writing through the spans is allowed; chunk
+		/// summaries are invalidated up front.
+		segment_view<value_type> segments() noexcept {
+			invalidate_summaries();
+			return segment_view<value_type>(first_chunk);
+		};
+
+		segment_view<const value_type> segments() const noexcept {
+			return segment_view<const value_type>(first_chunk);
+		};
+
+		/// CAPACITY
+
+		/// @brief Checks if the container has no elements
+		/// @return true if the container is empty, false otherwise
+		bool empty() const noexcept { return list_size == 0; };
+
+		/// @brief Returns the number of elements in the container
+		/// @return The number of elements in the container.
+		size_type size() const noexcept { return list_size; };
+
+		/// @brief Returns the maximum number of elements the container is able to
+		/// hold due to system or library implementation limitations
+		/// @return Maximum number of elements.
+		size_type max_size() const noexcept {
+			if (list_size == 0)
+				return 0;
+			if (list_size <= InlineN)
+				return InlineN;
+			size_type ordinal, offset;
+			size_policy.locate(list_size - 1 - InlineN, ordinal, offset);
+			return InlineN + size_policy.first_index(ordinal) + size_policy.capacity(ordinal);
+		};
+
+		/// @brief Returns the number of chunks allocated by the container.
+		/// @return The number of chunks.
+		size_type chunk_count() const noexcept { return num_of_chunks; };
+
+		/// @brief Requests the removal of unused capacity.
+		/// It is a non-binding request to reduce the memory usage without changing
+		/// the size of the sequence. All iterators and references are invalidated.
+		/// Past-the-end iterator is also invalidated.
+		void shrink_to_fit() {
+			if (list_size == 0) {
+				clear();
+				return;
+			}
+			// The last chunk grows back to the policy capacity on the next push_back
+			if (!is_inline(tail_chunk))
+				tail_chunk->resize(tail_chunk->num_of_elements);
+		}
+
+		/// STATISTICS
+
+		/// @brief Returns a snapshot of how the list uses its chunks, gathered by
+		/// walking them, and of the events counted since the list was
+		/// constructed or reset_stats() was called. Events are only counted when
+		/// CHUNKLIST_ENABLE_STATS is defined and read zero otherwise.
+		ChunkListStats stats() const {
+			ChunkListStats result;
+			if constexpr (stats_enabled)
+				static_cast<ChunkListCounters&>(result) = counters;
+			for (chunk_type* chunk = first_chunk; chunk != nullptr; chunk = chunk->next) {
+				result.chunks++;
+				result.capacity += chunk->chunk_size;
+				size_type bucket = chunk->num_of_elements * ChunkListStats::occupancy_buckets / chunk->chunk_size;
+				result.occupancy[std::min(bucket, ChunkListStats::occupancy_buckets - 1)]++;
+			}
+			result.elements = list_size;
+			result.slack_bytes = (result.capacity - list_size) * sizeof(value_type);
+			if (result.capacity > 0)
+				result.fill_factor = static_cast<double>(list_size) / static_cast<double>(result.capacity);
+			return result;
+		};
+
+		/// @brief Sets the event counters reported by stats() to zero.
+		void reset_stats() noexcept {
+			if constexpr (stats_enabled)
+				counters = ChunkListCounters();
+		};
+
+		/// MODIFIERS
+
+		/// @brief Erases all elements from the container.
+		/// nvalidates any references, pointers, or iterators referring to contained
+		/// elements. Any past-the-end iterators are also invalidated.
+		void clear() noexcept {
+			chunk_type* cur = first_chunk;
+			while (cur != nullptr) {
+				chunk_type* tmp = cur;
+				cur = cur->next;
+				release(tmp);
+			}
+			list_size = 0;
+			num_of_chunks = 0;
+			first_chunk = nullptr;
+			tail_chunk = nullptr;
+		};
+
+		/// @brief Inserts value before pos.
+		/// @param pos iterator before which the content will be inserted.
+		/// @param value element value to insert
+		/// @return Iterator pointing to the inserted value.
+		iterator insert(const_iterator pos, const T& value) {
+			if (pos == cend()) {
+				push_back(value);
+				return iterator(this, list_size - 1);
+			}
+			return insert_at(pos.get_index(), value);
+		};
+
+		/// @brief Inserts value before pos.
+		/// @param pos iterator before which the content will be inserted.
+		/// @param value element value to insert
+		/// @return Iterator pointing to the inserted value.
+		iterator insert(const_iterator pos, T&& value) {
+			if (pos == cend()) {
+				push_back(std::move(value));
+				return iterator(this, list_size - 1);
+			}
+			return insert_at(pos.get_index(), std::move(value));
+		};
+
+		private:
+		/// @brief Finds the chunk holding the element at pos and the offset of the
+		/// element inside it.
+		void locate(size_type pos, chunk_type*& chunk, size_type& offset) const {
+			if constexpr (InlineN > 0) {
+				if (pos < InlineN) {
+					chunk = first_chunk;
+					offset = pos;
+					return;
+				}
+				pos -= InlineN;
+			}
+			size_type chunk_index;
+			size_policy.locate(pos, chunk_index, offset);
+			chunk_index += inline_chunks;
+			record(&ChunkListCounters::lookup_hops, chunk_index);
+			chunk = first_chunk;
+			while (chunk_index > 0) {
+				chunk = chunk->next;
+				chunk_index--;
+			}
+		}
+
+		/// @brief Moves an iterator handle to the chunk after or before its own,
+		/// stepping the iterator's ChunkPrefetcher on a forward step and
+		/// dropping it on a backward one.
+		static chunk_type* adjacent_chunk(const void*& handle, const void*& lookahead, bool forward) noexcept {
+			chunk_type* chunk = static_cast<chunk_type*>(const_cast<void*>(handle));
+			chunk = forward ? chunk->next : chunk->prev;
+			handle = chunk;
+			if (forward)
+				prefetcher::step(lookahead, chunk);
+			else
+				lookahead = nullptr;
+			return chunk;
+		}
+
+		/// @brief Allocates a chunk sized by the policy and links it after the
+		/// last chunk.
+		chunk_type* append_chunk() {
+			chunk_type* chunk;
+			if (inline_chunks > 0 && num_of_chunks == 0)
+				chunk = inline_first_chunk();
+			else {
+				chunk = new chunk_type(size_policy.capacity(num_of_chunks - inline_chunks), allocator);
+				record(&ChunkListCounters::chunks_allocated);
+			}
+			chunk->prev = tail_chunk;
+			if (tail_chunk != nullptr)
+				tail_chunk->next = chunk;
+			else
+				first_chunk = chunk;
+			tail_chunk = chunk;
+			num_of_chunks++;
+			return chunk;
+		}
+
+		/// @brief Returns the last chunk, making sure it has room for one more
+		/// element.
+		chunk_type* back_chunk_with_room() {
+			if (tail_chunk == nullptr)
+				return append_chunk();
+			if (tail_chunk->num_of_elements < tail_chunk->chunk_size)
+				return tail_chunk;
+			if (!is_inline(tail_chunk)) {
+				size_type capacity = size_policy.capacity(num_of_chunks - 1 - inline_chunks);
+				if (tail_chunk->chunk_size < capacity) {
+					// The chunk was shrunk by shrink_to_fit
+					tail_chunk->resize(capacity);
+					return tail_chunk;
+				}
+			}
+			return append_chunk();
+		}
+
+		/// @brief Frees every chunk following chunk.
+		void release_chunks_after(chunk_type* chunk) {
+			chunk_type* cur = chunk->next;
+			while (cur != nullptr) {
+				chunk_type* tmp = cur;
+				cur = cur->next;
+				release(tmp);
+				num_of_chunks--;
+			}
+			chunk->next = nullptr;
+			tail_chunk = chunk;
+		}
+
+		/// @brief Removes the elements starting from count, freeing the chunks that
+		/// become empty. The first chunk is kept.
+		void truncate(size_type count) {
+			if (count >= size())
+				return;
+			chunk_type* curr_chunk;
+			size_type offset;
+			locate(count, curr_chunk, offset);
+			if (offset == 0 && curr_chunk != first_chunk) {
+				curr_chunk = curr_chunk->prev;
+				offset = curr_chunk->num_of_elements;
+			}
+			if constexpr (Summary::enabled) {
+				if (offset == 0)
+					curr_chunk->summary = Summary();
+				else
+					for (size_type i = offset; i < curr_chunk->num_of_elements; i++)
+						curr_chunk->summary.remove(curr_chunk->list[i]);
+			}
+			curr_chunk->num_of_elements = offset;
+			release_chunks_after(curr_chunk);
+			list_size = count;
+		}
+
+		/// @brief Returns the embedded first chunk, or nullptr if the list has none.
+		chunk_type* inline_first_chunk() noexcept {
+			if constexpr (InlineN > 0)
+				return &inline_chunk.chunk;
+			else
+				return nullptr;
+		}
+
+		bool is_inline(const chunk_type* chunk) const noexcept {
+			if constexpr (InlineN > 0)
+				return chunk == &inline_chunk.chunk;
+			else
+				return false;
+		}
+
+		/// @brief Frees a chunk unlinked from the chain; the embedded chunk is
+		/// only emptied.
+		void release(chunk_type* chunk) noexcept {
+			if (is_inline(chunk)) {
+				chunk->num_of_elements = 0;
+				chunk->prev = nullptr;
+				chunk->next = nullptr;
+				chunk->summary = Summary();
+			}
+			else {
+				delete chunk;
+				record(&ChunkListCounters::chunks_freed);
+			}
+		}
+
+		/// @brief Adds n to a counter reported by stats(). Compiles to nothing
+		/// unless CHUNKLIST_ENABLE_STATS is defined.
+		void record(std::size_t ChunkListCounters::* counter, size_type n = 1) const noexcept {
+			if constexpr (stats_enabled)
+				counters.*counter += n;
+		}
+
+		/// @brief Removes the last element without updating the summary of its
+		/// chunk, freeing the chunk if it becomes empty.
+		void drop_back() {
+			list_size--;
+			chunk_type* curr_chunk = last_chunk();
+			curr_chunk->num_of_elements--;
+
+			if (curr_chunk->num_of_elements == 0 && first_chunk != curr_chunk)
+				release_chunks_after(curr_chunk->prev);
+		}
+
+		/// @brief Takes over the chunks of other, leaving it empty. The container
+		/// must be empty. Elements of an embedded first chunk are moved.
+		void steal(ChunkList& other) noexcept {
+			first_chunk = other.first_chunk;
+			tail_chunk = other.tail_chunk;
+			list_size = other.list_size;
+			num_of_chunks = other.num_of_chunks;
+			if constexpr (InlineN > 0) {
+				if (other.is_inline(first_chunk)) {
+					chunk_type* own = inline_first_chunk();
+					std::move(first_chunk->begin(), first_chunk->end(), own->list);
+					own->num_of_elements = first_chunk->num_of_elements;
+					own->summary = first_chunk->summary;
+					own->next = first_chunk->next;
+					if (own->next != nullptr)
+						own->next->prev = own;
+					if (tail_chunk == first_chunk)
+						tail_chunk = own;
+					other.release(first_chunk);
+					first_chunk = own;
+				}
+			}
+			other.first_chunk = nullptr;
+			other.tail_chunk = nullptr;
+			other.list_size = 0;
+			other.num_of_chunks = 0;
+		}
+
+		/// @brief Copies every element of other to the end of the container.
+		void append_all(const ChunkList& other) {
+			prefetcher ahead(other.first_chunk);
+			for (chunk_type* chunk = other.first_chunk; chunk != nullptr; chunk = chunk->next, ahead.step()) {
+				for (value_type* el = chunk->begin(); el != chunk->end(); el++)
+					push_back(*el);
+			}
+		}
+
+		/// @brief Inserts value before the element at index. Every chunk but the
+		/// last one is full, so each chunk passes its last element on to the front
+		/// of the next one.
+		template <class V>
+		iterator insert_at(size_type index, V&& value) {
+			chunk_type* curr_chunk;
+			size_type offset;
+			locate(index, curr_chunk, offset);
+			value_type carry(std::forward<V>(value));
+			for (; curr_chunk != nullptr && curr_chunk->num_of_elements != 0; curr_chunk = curr_chunk->next, offset = 0) {
+				value_type* data = curr_chunk->list;
+				size_type count = curr_chunk->num_of_elements;
+				value_type last = std::move(data[count - 1]);
+				summary_remove(curr_chunk, last);
+				summary_add(curr_chunk, carry);
+				std::move_backward(data + offset, data + count - 1, data + count);
+				data[offset] = std::move(carry);
+				carry = std::move(last);
+				record(&ChunkListCounters::elements_moved, count - offset);
+			}
+			push_back(std::move(carry));
+			return iterator(this, index);
+		}
+
+		/// @brief Records that value is stored into chunk.
+		void summary_add(chunk_type* chunk, const value_type& value) {
+			if constexpr (Summary::enabled)
+				chunk->summary.add(value);
+		}
+
+		/// @brief Records that value is taken out of chunk, which still counts
+		/// it among its elements.
+		void summary_remove(chunk_type* chunk, const value_type& value) {
+			if constexpr (Summary::enabled) {
+				if (chunk->num_of_elements == 1)
+					chunk->summary = Summary();
+				else
+					chunk->summary.remove(value);
+			}
+		}
+
+		/// @brief Marks the summary of chunk as stale before its elements are
+		/// written in place.
+		static void touch(chunk_type* chunk) noexcept {
+			if constexpr (Summary::enabled)
+				chunk->summary.invalidate();
+		}
+
+		/// @brief Returns the summary of chunk, rebuilding it if it is stale.
+		static const Summary& summary_of(chunk_type* chunk) {
+			if (chunk->summary.stale())
+				chunk->summary.rebuild(chunk->begin(), chunk->end());
+			return chunk->summary;
+		}
+
+		static constexpr bool summarizes_bounds = requires (const Summary& summary, const T& value) {
+			{ summary.may_overlap(value, value) } -> std::convertible_to<bool>;
+			{ summary.all_within(value, value) } -> std::convertible_to<bool>;
+		};
+
+		static constexpr bool summarizes_members = requires (const Summary& summary, const T& value) {
+			{ summary.may_contain(value) } -> std::convertible_to<bool>;
+		};
+
+		static bool in_range(const T& value, const T& lo, const T& hi) {
+			return !(value < lo) && !(hi < value);
+		}
+
+		/// @brief Returns the position of the first element at or after from
+		/// matching match, scanning only the chunks whose summary passes
+		/// may_match, or size() if there is none.
+		template <class MayMatch, class Match>
+		size_type find_chunkwise(size_type from, MayMatch may_match, Match match) const {
+			if (from >= list_size)
+				return list_size;
+			chunk_type* chunk;
+			size_type offset;
+			locate(from, chunk, offset);
+			size_type chunk_start = from - offset;
+			prefetcher ahead(chunk);
+			for (; chunk != nullptr; chunk_start += chunk->num_of_elements, chunk = chunk->next, ahead.step(), offset = 0) {
+				if constexpr (Summary::enabled) {
+					if (!may_match(summary_of(chunk)))
+						continue;
+				}
+				for (size_type i = offset; i < chunk->num_of_elements; i++)
+					if (match(chunk->list[i]))
+						return chunk_start + i;
+			}
+			return list_size;
+		}
+
+		static constexpr bool caches_aggregates = requires (const Summary& summary) {
+			{ summary.sum() } -> std::convertible_to<T>;
+			{ summary.min() } -> std::convertible_to<T>;
+			{ summary.max() } -> std::convertible_to<T>;
+		};
+
+		/// @brief Calls whole with the summary of every chunk lying entirely in
+		/// positions [first, last), or element with each of its elements if the
+		/// summary caches no aggregates, and element with the elements of the
+		/// chunks at either end.
+		template <class Whole, class Element>
+		void reduce_range(size_type first, size_type last, Whole whole, Element element) const {
+			if (first > last || last > list_size)
+				throw std::out_of_range("Out of range");
+			if (first == last)
+				return;
+			chunk_type* chunk;
+			size_type offset;
+			locate(first, chunk, offset);
+			prefetcher ahead(chunk);
+			while (first < last) {
+				size_type take = std::min(chunk->num_of_elements - offset, last - first);
+				if constexpr (caches_aggregates) {
+					if (take == chunk->num_of_elements) {
+						whole(summary_of(chunk));
+						first += take;
+						chunk = chunk->next;
+						ahead.step();
+						continue;
+					}
+				}
+				for (size_type i = offset; i < offset + take; i++)
+					element(chunk->list[i]);
+				first += take;
+				chunk = chunk->next;
+				ahead.step();
+				offset = 0;
+			}
+		}
+
+		/// @brief Returns the best element of positions [first, last), where
+		/// better(a, b) tells if a beats b and cached gives the best element of a
+		/// whole chunk from its summary.
+		template <class Cached, class Better>
+		value_type range_extreme(size_type first, size_type last, Cached cached, Better better) const {
+			if (first >= last)
+				throw std::out_of_range("Empty range");
+			value_type best{};
+			bool found = false;
+			auto consider = [&](const value_type& value) {
+				if (!found || better(value, best)) {
+					best = value;
+					found = true;
+				}
+			};
+			reduce_range(first, last,
+				[&](const Summary& summary) { consider(cached(summary)); },
+				consider);
+			return best;
+		}
+
+		static constexpr bool uniform_chunks = requires { requires SizePolicy::uniform; };
+
+		/// @brief Makes room for count elements before index and calls
+		/// fill(dest, n) with consecutive runs of the new slots, in order, to fill
+		/// them. Elements from index on are moved once; see splice_fill for the
+		/// case where they do not move at all.
+		template <class Fill>
+		void insert_fill(size_type index, size_type count, Fill fill) {
+			if (index > list_size)
+				throw std::out_of_range("Out of range");
+			if (count == 0)
+				return;
+			if constexpr (uniform_chunks) {
+				if (index < list_size && splice_fill(index, count, fill))
+					return;
+			}
+			size_type old_size = list_size;
+			extend(count);
+			shift_tail(index, old_size, count);
+
+			chunk_type* curr_chunk;
+			size_type offset;
+			locate(index, curr_chunk, offset);
+			for (; count > 0; curr_chunk = curr_chunk->next, offset = 0) {
+				size_type step = std::min(count, curr_chunk->num_of_elements - offset);
+				fill(curr_chunk->list + offset, step);
+				touch(curr_chunk);
+				count -= step;
+			}
+		}
+
+		/// @brief Moves the elements [index, old_size) count slots to the right,
+		/// a chunk-sized run at a time, starting from the end.
+		void shift_tail(size_type index, size_type old_size, size_type count) {
+			if (index == old_size)
+				return;
+			chunk_type *src, *dst;
+			size_type src_last, dst_last;
+			locate(old_size - 1, src, src_last);
+			locate(old_size - 1 + count, dst, dst_last);
+			size_type left = old_size - index;
+			while (true) {
+				size_type step = std::min({ left, src_last + 1, dst_last + 1 });
+				std::move_backward(src->list + src_last + 1 - step, src->list + src_last + 1, dst->list + dst_last + 1);
+				touch(dst);
+				record(&ChunkListCounters::elements_moved, step);
+				left -= step;
+				if (left == 0)
+					return;
+				if (src_last + 1 == step) {
+					src = src->prev;
+					src_last = src->num_of_elements - 1;
+				}
+				else {
+					src_last -= step;
+				}
+				if (dst_last + 1 == step) {
+					dst = dst->prev;
+					dst_last = dst->num_of_elements - 1;
+				}
+				else {
+					dst_last -= step;
+				}
+			}
+		}
+
+		/// @brief Inserts count elements before index by linking freshly built
+		/// chunks after the chunk holding index, without moving the elements that
+		/// follow. Only possible when every chunk has the same capacity and count
+		/// is a multiple of it, since every chunk but the last must stay full.
+		/// @return false if the insertion has to shift elements instead.
+		template <class Fill>
+		bool splice_fill(size_type index, size_type count, Fill& fill) {
+			chunk_type* curr_chunk;
+			size_type offset;
+			locate(index, curr_chunk, offset);
+			size_type capacity = size_policy.capacity(0);
+			if (count % capacity != 0 || is_inline(curr_chunk) || curr_chunk->chunk_size != capacity
+				|| curr_chunk->num_of_elements != capacity)
+				return false;
+
+			// Build the new chunks off the chain first
+			chunk_type* head = nullptr;
+			chunk_type* last = nullptr;
+			try {
+				for (size_type i = 0; i < count / capacity; i++) {
+					chunk_type* chunk = new chunk_type(capacity, allocator);
+					record(&ChunkListCounters::chunks_allocated);
+					chunk->num_of_elements = capacity;
+					touch(chunk);
+					chunk->prev = last;
+					if (last != nullptr)
+						last->next = chunk;
+					else
+						head = chunk;
+					last = chunk;
+				}
+			}
+			catch (...) {
+				free_chain(head);
+				throw;
+			}
+
+			// The elements after offset end the new chunks, and the first new
+			// elements take their place
+			size_type suffix = capacity - offset;
+			std::move(curr_chunk->list + offset, curr_chunk->list + capacity, last->list + capacity - suffix);
+			record(&ChunkListCounters::elements_moved, suffix);
+			try {
+				fill(curr_chunk->list + offset, suffix);
+				size_type left = count - suffix;
+				for (chunk_type* chunk = head; left > 0; chunk = chunk->next) {
+					size_type step = std::min(left, capacity);
+					fill(chunk->list, step);
+					left -= step;
+				}
+			}
+			catch (...) {
+				std::move(last->list + capacity - suffix, last->list + capacity, curr_chunk->list + offset);
+				free_chain(head);
+				throw;
+			}
+			touch(curr_chunk);
+
+			last->next = curr_chunk->next;
+			if (curr_chunk->next != nullptr)
+				curr_chunk->next->prev = last;
+			else
+				tail_chunk = last;
+			curr_chunk->next = head;
+			head->prev = curr_chunk;
+			num_of_chunks += count / capacity;
+			list_size += count;
+			return true;
+		}
+
+		/// @brief Checks if the chunks of other can be linked in at index without
+		/// moving elements: every chunk of both lists has the same capacity and
+		/// index is the first position of a chunk.
+		bool relinkable(size_type index, const ChunkList& other) const noexcept {
+			if constexpr (uniform_chunks && InlineN == 0) {
+				size_type capacity = size_policy.capacity(0);
+				return index % capacity == 0 && other.size_policy.capacity(0) == capacity
+					&& (tail_chunk == nullptr || tail_chunk->chunk_size == capacity)
+					&& (other.tail_chunk == nullptr || other.tail_chunk->chunk_size == capacity);
+			}
+			else {
+				return false;
+			}
+		}
+
+		/// @brief Takes over the counts and the tail of other, whose chain has
+		/// already been linked in, leaving other empty.
+		void adopt_chain(ChunkList& other) noexcept {
+			tail_chunk = other.tail_chunk;
+			list_size += other.list_size;
+			num_of_chunks += other.num_of_chunks;
+			other.first_chunk = nullptr;
+			other.tail_chunk = nullptr;
+			other.list_size = 0;
+			other.num_of_chunks = 0;
+		}
+
+		/// @brief Links a chunk for the next output position of a merge after the
+		/// last one, reusing a consumed input chunk from spare when its capacity
+		/// fits.
+		chunk_type* append_recycled(chunk_type*& spare) {
+			size_type capacity = size_policy.capacity(num_of_chunks);
+			chunk_type* chunk;
+			if (spare != nullptr && spare->chunk_size == capacity) {
+				chunk = spare;
+				spare = spare->next;
+				chunk->next = nullptr;
+				chunk->num_of_elements = 0;
+				chunk->summary = Summary();
+			}
+			else {
+				chunk = new chunk_type(capacity, allocator);
+				record(&ChunkListCounters::chunks_allocated);
+			}
+			chunk->prev = tail_chunk;
+			if (tail_chunk != nullptr)
+				tail_chunk->next = chunk;
+			else
+				first_chunk = chunk;
+			tail_chunk = chunk;
+			num_of_chunks++;
+			return chunk;
+		}
+
+		/// @brief Appends the elements of the container and other, merged, to
+		/// out, moving them.
+		template <class Compare>
+		void merge_into(ChunkList& out, ChunkList& other, Compare& comp) {
+			iterator a = begin(), a_end = end();
+			iterator b = other.begin(), b_end = other.end();
+			while (a != a_end || b != b_end) {
+				if (a == a_end || (b != b_end && comp(std::as_const(*b), std::as_const(*a))))
+					out.push_back(std::move(*b++));
+				else
+					out.push_back(std::move(*a++));
+			}
+			other.clear();
+		}
+
+		/// @brief Returns how many of the first diagonal elements of the merge of
+		/// the container and other come from the container, by a binary search
+		/// along the merge path. Equal elements of the container go first.
+		template <class Compare>
+		size_type merge_path_split(size_type diagonal, const ChunkList& other, Compare& comp) const {
+			size_type lo = diagonal > other.list_size ? diagonal - other.list_size : 0;
+			size_type hi = std::min(diagonal, list_size);
+			while (lo < hi) {
+				size_type i = lo + (hi - lo) / 2;
+				if (comp(other[diagonal - i - 1], (*this)[i]))
+					hi = i;
+				else
+					lo = i + 1;
+			}
+			return lo;
+		}
+
+		/// @brief Frees a chain of chunks that is not linked into the list.
+		void free_chain(chunk_type* chunk) noexcept {
+			while (chunk != nullptr) {
+				chunk_type* next = chunk->next;
+				delete chunk;
+				record(&ChunkListCounters::chunks_freed);
+				chunk = next;
+			}
+		}
+
+		public:
+		/// @brief Inserts count copies of the value before pos. Runs in time
+		/// linear in count plus the number of elements after pos, or in count
+		/// plus one chunk when the new elements fill whole chunks of a list with
+		/// chunks of one size.
+		/// @param pos iterator before which the content will be inserted.
+		/// @param count number of elements to insert
+		/// @param value element value to insert
+		/// @return Iterator pointing to the first element inserted, or pos if count
+		/// == 0.
+		iterator insert(const_iterator pos, size_type count, const T& value) {
+			size_type index = pos.get_index();
+			insert_fill(index, count, [&value](value_type* dest, size_type n) {
+				std::fill_n(dest, n, value);
+				});
+			return iterator(this, index);
+		}
+
+		/// @brief Inserts elements from range [first, last) before pos, in the
+		/// time given for the count overload. Elements of a single pass range are
+		/// gathered first.
+		/// @tparam InputIt Input Iterator
+		/// @param pos iterator before which the content will be inserted.
+		/// @param first,last the range of elements to insert, can't be iterators into
+		/// container for which insert is called
+		/// @return Iterator pointing to the first element inserted, or pos if first
+		/// == last.
+		template <std::input_iterator InputIt>
+		iterator insert(const_iterator pos, InputIt first, InputIt last) {
+			size_type index = pos.get_index();
+			if constexpr (std::forward_iterator<InputIt> || std::sized_sentinel_for<InputIt, InputIt>) {
+				size_type count = static_cast<size_type>(std::ranges::distance(first, last));
+				insert_fill(index, count, [&first](value_type* dest, size_type n) {
+					for (size_type i = 0; i < n; i++, ++first)
+						dest[i] = *first;
+					});
+			}
+			else {
+				ChunkList gathered(size_policy, allocator);
+				for (; first != last; ++first)
+					gathered.push_back(*first);
+				auto source = gathered.begin();
+				insert_fill(index, gathered.size(), [&source](value_type* dest, size_type n) {
+					for (size_type i = 0; i < n; i++, ++source)
+						dest[i] = std::move(*source);
+					});
+			}
+			return iterator(this, index);
+		}
+
+		/// @brief Inserts elements from initializer list before pos.
+		/// @param pos iterator before which the content will be inserted.
+		/// @param ilist initializer list to insert the values from
+		/// @return Iterator pointing to the first element inserted, or pos if ilist
+		/// is empty.
+		iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+			return insert(pos, ilist.begin(), ilist.end());
+		}
+
+		/// @brief Inserts a new element into the container directly before pos.
+		/// @param pos iterator before which the new element will be constructed
+		/// @param ...args arguments to forward to the constructor of the element
+		/// @return terator pointing to the emplaced element.
+		template <class... Args>
+		iterator emplace(const_iterator pos, Args&&... args) {
+			return insert(pos, T(std::forward<Args>(args)...));
+		}
+
+		/// @brief Removes the element at pos.
+		/// @param pos iterator to the element to remove
+		/// @return Iterator following the last removed element.
+		iterator erase(const_iterator pos) {
+			size_type index = pos.get_index();
+			chunk_type* curr_chunk;
+			size_type offset;
+			locate(index, curr_chunk, offset);
+
+			// Shift the tail one slot to the left, pulling the first element of
+			// every following chunk into the end of the previous one
+			summary_remove(curr_chunk, curr_chunk->list[offset]);
+			while (true) {
+				value_type* data = curr_chunk->list;
+				std::move(data + offset + 1, data + curr_chunk->num_of_elements, data + offset);
+				record(&ChunkListCounters::elements_moved, curr_chunk->num_of_elements - offset - 1);
+				chunk_type* next = curr_chunk->next;
+				if (next == nullptr || next->num_of_elements == 0)
+					break;
+				summary_add(curr_chunk, next->list[0]);
+				summary_remove(next, next->list[0]);
+				data[curr_chunk->num_of_elements - 1] = std::move(next->list[0]);
+				record(&ChunkListCounters::elements_moved);
+				curr_chunk = next;
+				offset = 0;
+			}
+			drop_back();
+
+			return iterator(this, index);
+		};
+
+		/// @brief Removes the elements in the range [first, last). A write cursor
+		/// at first and a read cursor at last walk the chunks in step, so the
+		/// elements after the range are moved down in one pass, then the chunks
+		/// left empty at the end are freed.
+		/// @param first,last range of elements to remove
+		/// @return Iterator following the last removed element.
+		iterator erase(const_iterator first, const_iterator last) {
+			size_type start_index = first.get_index();
+			size_type end_index = last.get_index();
+			if (start_index >= end_index)
+				return iterator(this, start_index);
+
+			size_type moved = list_size - end_index;
+			if (moved > 0) {
+				chunk_type *write_chunk, *read_chunk;
+				size_type write_offset, read_offset;
+				locate(start_index, write_chunk, write_offset);
+				locate(end_index, read_chunk, read_offset);
+				touch(write_chunk);
+				prefetcher ahead(read_chunk);
+				for (size_type k = 0; k < moved; k++) {
+					if (read_offset == read_chunk->num_of_elements) {
+						read_chunk = read_chunk->next;
+						read_offset = 0;
+						ahead.step();
+					}
+					if (write_offset == write_chunk->num_of_elements) {
+						write_chunk = write_chunk->next;
+						write_offset = 0;
+						touch(write_chunk);
+					}
+					write_chunk->list[write_offset++] = std::move(read_chunk->list[read_offset++]);
+				}
+				record(&ChunkListCounters::elements_moved, moved);
+			}
+			truncate(list_size - (end_index - start_index));
+			return iterator(this, start_index);
+		}
+
+		/// @brief Removes all elements for which pred returns true, keeping the
+		/// order of the others. A read cursor and a write cursor walk the chunks in
+		/// step, so the whole list is compacted in one pass, then the chunks left
+		/// empty at the end are freed.
+		/// @param pred unary predicate which returns true if the element should be
+		/// removed
+		/// @return The number of removed elements.
+		template <class Pred>
+		size_type remove_if(Pred pred) {
+			chunk_type* write_chunk = first_chunk;
+			size_type write_offset = 0;
+			size_type kept = 0;
+			prefetcher ahead(first_chunk);
+			for (chunk_type* read_chunk = first_chunk; read_chunk != nullptr; read_chunk = read_chunk->next, ahead.step()) {
+				value_type* data = read_chunk->list;
+				for (size_type i = 0; i < read_chunk->num_of_elements; i++) {
+					if (pred(std::as_const(data[i])))
+						continue;
+					if (write_offset == write_chunk->num_of_elements) {
+						write_chunk = write_chunk->next;
+						write_offset = 0;
+					}
+					value_type* slot = write_chunk->list + write_offset;
+					if (slot != data + i) {
+						*slot = std::move(data[i]);
+						touch(write_chunk);
+						record(&ChunkListCounters::elements_moved);
+					}
+					write_offset++;
+					kept++;
+				}
+			}
+			size_type removed = list_size - kept;
+			truncate(kept);
+			return removed;
+		}
+
+		/// @brief Removes all elements equal to value in one pass, see remove_if.
+		/// @param value value of the elements to remove
+		/// @return The number of removed elements.
+		template <class U>
+		size_type remove(const U& value) {
+			return remove_if([&value](const value_type& el) { return el == value; });
+		}
+
+		/// @brief Appends the given element value to the end of the container.
+		/// The new element is initialized as a copy of value.
+		/// @param value the value of the element to append
+		void push_back(const T& value) {
+			chunk_type* curr_chunk = back_chunk_with_room();
+			summary_add(curr_chunk, value);
+			curr_chunk->list[curr_chunk->num_of_elements++] = value;
+			list_size++;
+		}
+
+		/// @brief Appends the given element value to the end of the container.
+		/// Value is moved into the new element.
+		/// @param value the value of the element to append
+		void push_back(T&& value) {
+			chunk_type* curr_chunk = back_chunk_with_room();
+			summary_add(curr_chunk, value);
+			curr_chunk->list[curr_chunk->num_of_elements++] = std::move(value);
+			list_size++;
+		};
+
+		/// @brief Appends a new element to the end of the container.
+		/// @param ...args arguments to forward to the constructor of the element
+		/// @return A reference to the inserted element.
+		template <class... Args>
+		reference emplace_back(Args&&... args) {
+			chunk_type* curr_chunk = back_chunk_with_room();
+			curr_chunk->list[curr_chunk->num_of_elements++] = value_type(std::forward<Args>(args)...);
+			list_size++;
+			summary_add(curr_chunk, curr_chunk->list[curr_chunk->num_of_elements - 1]);
+			return curr_chunk->list[curr_chunk->num_of_elements - 1];
+		}
+
+		/// @brief Removes the last element of the container.
+		void pop_back() {
+			if (list_size == 0) {
+				return;
+			}
+
+			chunk_type* curr_chunk = last_chunk();
+			summary_remove(curr_chunk, curr_chunk->list[curr_chunk->num_of_elements - 1]);
+			drop_back();
+		}
+
+		/// @brief Prepends the given element value to the beginning of the container.
+		/// @param value the value of the element to prepend
+		void push_front(const T& value) {
+			insert(cbegin(), value);
+		};
+
+		/// @brief Prepends the given element value to the beginning of the container.
+		/// @param value moved value of the element to prepend
+		void push_front(T&& value) {
+			insert(cbegin(), std::move(value));
+		};
+
+		/// @brief Inserts a new element to the beginning of the container.
+		/// @param ...args arguments to forward to the constructor of the element
+		/// @return A reference to the inserted element.
+		template <class... Args>
+		reference emplace_front(Args&&... args) {
+			if (empty())
+				return emplace_back(std::forward<Args>(args)...);
+			auto it = insert(cbegin(), value_type(std::forward<Args>(args)...));
+			return *it;
+		};
+
+		/// @brief Removes the first element of the container.
+		void pop_front() {
+			erase(cbegin());
+		};
+
+		/// @brief Resizes the container to contain count elements.
+		/// If the current size is greater than count, the container is reduced to its
+		/// first count elements. If the current size is less than count, additional
+		/// default-inserted elements are appended
+		/// @param count new size of the container
+		void resize(size_type count) {
+			if (count < size()) {
+				truncate(count);
+				return;
+			}
+			while (size() < count)
+				emplace_back();
+		};
+
+		/// @brief Resizes the container to contain count elements.
+		/// If the current size is greater than count, the container is reduced to its
+		/// first count elements. If the current size is less than count, additional
+		/// copies of value are appended.
+		/// @param count new size of the container
+		/// @param value the value to initialize the new elements with
+		void resize(size_type count, const value_type& value) {
+			if (count < size()) {
+				truncate(count);
+				return;
+			}
+			while (size() < count)
+				push_back(value);
+		};
+
+		/// @brief Appends count elements a chunk at a time without assigning them.
+		/// The new elements keep whatever value their slots hold, default-initialized
+		/// or left by removed elements, and are meant to be overwritten in place,
+		/// e.g. by scatter_read().
+		/// @param count number of elements to append
+		void extend(size_type count) {
+			while (count > 0) {
+				chunk_type* curr_chunk = back_chunk_with_room();
+				size_type step = std::min(count, curr_chunk->chunk_size - curr_chunk->num_of_elements);
+				touch(curr_chunk);
+				curr_chunk->num_of_elements += step;
+				list_size += step;
+				count -= step;
+			}
+		};
+
+		/// SPLICING
+		///
+		/// Positions are mapped to chunks by arithmetic, so every chunk but the
+		/// last is full. Chunks of other are relinked without touching their
+		/// elements when they line up with the chunks of the container: every
+		/// chunk has the same capacity and the boundary falls between two chunks.
+		/// Otherwise the elements on one side of the boundary are moved.
+
+		/// @brief Moves the elements of other to the end of the container, leaving
+		/// other empty. Takes O(chunks) when size() is a multiple of the chunk
+		/// capacity or the container is empty, e.g. when concatenating lists
+		/// filled in whole chunks; otherwise the elements of other are moved and
+		/// its chunks are freed as they empty.
+		/// @param other list to take the elements of
+		void append(ChunkList&& other) {
+			if (&other == this || other.empty())
+				return;
+			if (empty() && size_policy.capacity(0) == other.size_policy.capacity(0)) {
+				clear();
+				steal(other);
+				return;
+			}
+			if (relinkable(list_size, other)) {
+				tail_chunk->next = other.first_chunk;
+				other.first_chunk->prev = tail_chunk;
+				adopt_chain(other);
+				return;
+			}
+			while (other.first_chunk != nullptr) {
+				chunk_type* chunk = other.first_chunk;
+				other.first_chunk = chunk->next;
+				for (value_type* el = chunk->begin(); el != chunk->end(); el++)
+					push_back(std::move(*el));
+				other.release(chunk);
+			}
+			other.tail_chunk = nullptr;
+			other.list_size = 0;
+			other.num_of_chunks = 0;
+		};
+
+		/// @brief Moves the elements of other before pos, leaving other empty.
+		/// Takes O(chunks) when pos and other.size() are multiples of the chunk
+		/// capacity; otherwise it costs a range insert of the moved elements.
+		/// @param pos iterator before which the elements will be inserted
+		/// @param other list to take the elements of
+		/// @throw std::out_of_range if pos is past the end
+		void splice(const_iterator pos, ChunkList& other) {
+			size_type index = pos.get_index();
+			if (index > list_size)
+				throw std::out_of_range("Out of range");
+			if (&other == this || other.empty())
+				return;
+			if (index == list_size) {
+				append(std::move(other));
+				return;
+			}
+			if (relinkable(index, other) && other.list_size % size_policy.capacity(0) == 0) {
+				chunk_type* chunk;
+				size_type offset;
+				locate(index, chunk, offset);
+				if (chunk->prev != nullptr)
+					chunk->prev->next = other.first_chunk;
+				else
+					first_chunk = other.first_chunk;
+				other.first_chunk->prev = chunk->prev;
+				other.tail_chunk->next = chunk;
+				chunk->prev = other.tail_chunk;
+				chunk_type* own_tail = tail_chunk;
+				adopt_chain(other);
+				tail_chunk = own_tail;
+				return;
+			}
+			insert(pos, std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+			other.clear();
+		};
+
+		void splice(const_iterator pos, ChunkList&& other) {
+			splice(pos, other);
+		};
+
+		/// @brief Splits the container in two at index: the container keeps the
+		/// elements before index and the ones from index on are returned. Takes
+		/// O(chunks) when index is a multiple of the chunk capacity; otherwise
+		/// the returned elements are moved.
+		/// @param index position of the first element to split off
+		/// @return List holding the elements [index, size()).
+		/// @throw std::out_of_range if index is past the end
+		ChunkList split_at(size_type index) {
+			if (index > list_size)
+				throw std::out_of_range("Out of range");
+			ChunkList result(size_policy, allocator);
+			if (index == list_size)
+				return result;
+			if (index == 0) {
+				result.steal(*this);
+				return result;
+			}
+			chunk_type* chunk;
+			size_type offset;
+			locate(index, chunk, offset);
+			if (relinkable(index, *this)) {
+				size_type kept_chunks = index / size_policy.capacity(0);
+				result.first_chunk = chunk;
+				result.tail_chunk = tail_chunk;
+				result.list_size = list_size - index;
+				result.num_of_chunks = num_of_chunks - kept_chunks;
+				tail_chunk = chunk->prev;
+				tail_chunk->next = nullptr;
+				chunk->prev = nullptr;
+				list_size = index;
+				num_of_chunks = kept_chunks;
+				return result;
+			}
+			for (; chunk != nullptr; chunk = chunk->next, offset = 0)
+				for (size_type i = offset; i < chunk->num_of_elements; i++)
+					result.push_back(std::move(chunk->list[i]));
+			truncate(index);
+			return result;
+		};
+
+		/// @brief Merges the sorted list other into the sorted container, leaving
+		/// other empty. The merge is stable: equal elements of the container come
+		/// before those of other. Elements are moved from both inputs a chunk at a
+		/// time into output chunks, and every input chunk is recycled as output
+		/// storage once it is consumed, so at most a couple of chunks are
+		/// allocated on top of the inputs. Lists with an embedded chunk are merged
+		/// into a separate list instead, since that chunk is both the first input
+		/// and the first output chunk.
+		/// @param other sorted list to merge in
+		/// @param comp comparison function object which returns true if the first
+		/// argument is less than the second
+		template <class Compare = std::less<>>
+		void merge(ChunkList&& other, Compare comp = Compare()) {
+			if (&other == this || other.empty())
+				return;
+			if (empty()) {
+				append(std::move(other));
+				return;
+			}
+			if constexpr (InlineN > 0) {
+				ChunkList merged(size_policy, allocator);
+				merge_into(merged, other, comp);
+				clear();
+				steal(merged);
+				return;
+			}
+			chunk_type* a = first_chunk;
+			chunk_type* b = other.first_chunk;
+			other.first_chunk = other.tail_chunk = nullptr;
+			other.list_size = other.num_of_chunks = 0;
+			first_chunk = tail_chunk = nullptr;
+			list_size = num_of_chunks = 0;
+
+			chunk_type* spare = nullptr;
+			size_type ai = 0, bi = 0;
+			chunk_type* out = nullptr;
+			while (a != nullptr || b != nullptr) {
+				bool from_b = a == nullptr || (b != nullptr && comp(std::as_const(b->list[bi]), std::as_const(a->list[ai])));
+				chunk_type*& source = from_b ? b : a;
+				size_type& offset = from_b ? bi : ai;
+				if (out == nullptr || out->num_of_elements == out->chunk_size)
+					out = append_recycled(spare);
+				summary_add(out, source->list[offset]);
+				out->list[out->num_of_elements++] = std::move(source->list[offset]);
+				list_size++;
+				if (++offset == source->num_of_elements) {
+					// The chunk is consumed, keep it for the output
+					chunk_type* next = source->next;
+					source->next = spare;
+					spare = source;
+					source = next;
+					offset = 0;
+				}
+			}
+			free_chain(spare);
+		};
+
+		template <class Compare = std::less<>>
+		void merge(ChunkList& other, Compare comp = Compare()) {
+			merge(std::move(other), comp);
+		};
+
+		/// @brief Merges like merge(), splitting the output into equal ranges that
+		/// are merged by separate threads. The input position where each range
+		/// starts is found by a binary search along the merge path. The output is
+		/// built in new chunks, so this needs memory for a full copy; use it for
+		/// inputs large enough to be worth the threads.
+		/// @param other sorted list to merge in
+		/// @param comp comparison function object which returns true if the first
+		/// argument is less than the second
+		/// @param threads number of ranges merged at once
+		template <class Compare = std::less<>>
+		void parallel_merge(ChunkList&& other, Compare comp = Compare(),
+			unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+			if (&other == this || other.empty())
+				return;
+			size_type total = list_size + other.list_size;
+			ChunkList merged(size_policy, allocator);
+			merged.extend(total);
+
+			// Every split and starting chunk is found here, before any range is
+			// merged: a worker moves elements out of its own inputs, so nothing
+			// outside of them may be read once the workers have started
+			struct Cursor {
+				size_type ai, bi;
+				chunk_type *a = nullptr, *b = nullptr, *out = nullptr;
+				size_type a_offset = 0, b_offset = 0, out_offset = 0;
+			};
+			// Ranges shorter than a few thousand elements are not worth a thread
+			size_type parts = std::max<size_type>(1, std::min<size_type>(threads, total / 4096));
+			std::vector<Cursor> cursors(parts + 1);
+			for (size_type p = 0; p <= parts; p++) {
+				Cursor& cursor = cursors[p];
+				size_type first = total * p / parts;
+				cursor.ai = merge_path_split(first, other, comp);
+				cursor.bi = first - cursor.ai;
+				if (p == parts)
+					break;
+				if (cursor.ai < list_size)
+					locate(cursor.ai, cursor.a, cursor.a_offset);
+				if (cursor.bi < other.list_size)
+					other.locate(cursor.bi, cursor.b, cursor.b_offset);
+				merged.locate(first, cursor.out, cursor.out_offset);
+			}
+
+			auto merge_range = [](Cursor cursor, const Cursor& last, Compare comp) {
+				while (cursor.ai < last.ai || cursor.bi < last.bi) {
+					bool from_b = cursor.ai == last.ai || (cursor.bi < last.bi
+						&& comp(std::as_const(cursor.b->list[cursor.b_offset]), std::as_const(cursor.a->list[cursor.a_offset])));
+					chunk_type*& source = from_b ? cursor.b : cursor.a;
+					size_type& offset = from_b ? cursor.b_offset : cursor.a_offset;
+					cursor.out->list[cursor.out_offset] = std::move(source->list[offset]);
+					(from_b ? cursor.bi : cursor.ai)++;
+					if (++offset == source->num_of_elements) {
+						source = source->next;
+						offset = 0;
+					}
+					if (++cursor.out_offset == cursor.out->num_of_elements) {
+						cursor.out = cursor.out->next;
+						cursor.out_offset = 0;
+					}
+				}
+			};
+
+			std::vector<std::future<void>> workers;
+			for (size_type p = 1; p < parts; p++)
+				workers.push_back(std::async(std::launch::async, merge_range, cursors[p], std::cref(cursors[p + 1]), comp));
+			merge_range(cursors[0], cursors[1], comp);
+			for (auto& worker : workers)
+				worker.get();
+
+			clear();
+			other.clear();
+			steal(merged);
+		};
+
+		/// @brief Exchanges the contents of the container with those of other.
+		/// Does not invoke any move, copy, or swap operations on individual elements.
+		/// All iterators and references remain valid. The past-the-end iterator is
+		/// invalidated.
+		/// @param other container to exchange the contents with
+		void swap(ChunkList& other) {
+			if constexpr (InlineN > 0) {
+				// Elements of the embedded chunks have to move between the objects
+				ChunkList tmp(std::move(other));
+				other.size_policy = size_policy;
+				other.allocator = allocator;
+				other.steal(*this);
+				size_policy = tmp.size_policy;
+				allocator = tmp.allocator;
+				steal(tmp);
+				return;
+			}
+			std::swap(other.first_chunk, first_chunk);
+			std::swap(other.tail_chunk, tail_chunk);
+			std::swap(other.list_size, list_size);
+			std::swap(other.num_of_chunks, num_of_chunks);
+			std::swap(other.size_policy, size_policy);
+			std::swap(other.allocator, allocator);
+		}
+
+		/// @brief Print the content of ChunkList to console.
+		void print() {
+			int chunk_num = 1;
+			chunk_type* curr_chunk = first_chunk;
+			while (curr_chunk != nullptr) {
+				std::cout << "Chunk num: " << chunk_num << std::endl;
+				for (value_type* el = curr_chunk->begin(); el != curr_chunk->end(); el++)
+					std::cout << *el << "\t";
+				std::cout << std::endl;
+
+				chunk_num++;
+				curr_chunk = curr_chunk->next;
+			}
+		}
+
+		/// RANGE QUERIES
+
+		/// @brief Returns the number of elements in the closed range [lo, hi].
+		/// With a Summary keeping bounds, e.g. ZoneMap, chunks outside the range
+		/// are skipped and chunks inside it are counted without being read.
+		/// @param lo,hi bounds of the range, compared with operator<
+		size_type count_in_range(const T& lo, const T& hi) const {
+			size_type result = 0;
+			prefetcher ahead(first_chunk);
+			for (chunk_type* chunk = first_chunk; chunk != nullptr; chunk = chunk->next, ahead.step()) {
+				if constexpr (summarizes_bounds) {
+					const Summary& summary = summary_of(chunk);
+					if (!summary.may_overlap(lo, hi))
+						continue;
+					if (summary.all_within(lo, hi)) {
+						result += chunk->num_of_elements;
+						continue;
+					}
+				}
+				for (const value_type* el = chunk->begin(); el != chunk->end(); el++)
+					if (in_range(*el, lo, hi))
+						result++;
+			}
+			return result;
+		};
+
+		/// @brief Calls f in order with every element in the closed range
+		/// [lo, hi], skipping the chunks whose summary rules them out.
+		/// @param lo,hi bounds of the range, compared with operator<
+		/// @param f callable taking a const reference to an element
+		template <class F>
+		void filter_range(const T& lo, const T& hi, F f) const {
+			prefetcher ahead(first_chunk);
+			for (chunk_type* chunk = first_chunk; chunk != nullptr; chunk = chunk->next, ahead.step()) {
+				if constexpr (summarizes_bounds) {
+					if (!summary_of(chunk).may_overlap(lo, hi))
+						continue;
+				}
+				for (const value_type* el = chunk->begin(); el != chunk->end(); el++)
+					if (in_range(*el, lo, hi))
+						f(*el);
+			}
+		};
+
+		/// @brief Returns the position of the first element in the closed range
+		/// [lo, hi] at or after from, or size() if there is none.
+		/// @param lo,hi bounds of the range, compared with operator<
+		/// @param from position to start the search at
+		size_type find_in_range(const T& lo, const T& hi, size_type from = 0) const {
+			return find_chunkwise(from,
+				[&](const Summary& summary) {
+					if constexpr (summarizes_bounds)
+						return summary.may_overlap(lo, hi);
+					else
+						return true;
+				},
+				[&](const value_type& value) { return in_range(value, lo, hi); });
+		};
+
+		/// @brief Returns the position of the first element equal to value at or
+		/// after from, or size() if there is none. A Summary with a membership
+		/// filter, e.g. ZoneMap with Bloom bits, lets most chunks be skipped.
+		/// @param value value to search for
+		/// @param from position to start the search at
+		size_type find_value(const T& value, size_type from = 0) const {
+			return find_chunkwise(from,
+				[&](const Summary& summary) {
+					bool result = true;
+					if constexpr (summarizes_bounds)
+						result = summary.may_overlap(value, value);
+					if constexpr (summarizes_members)
+						result = result && summary.may_contain(value);
+					return result;
+				},
+				[&](const value_type& el) { return el == value; });
+		};
+
+		/// @brief Returns the sum of the elements at positions [first, last). With
+		/// a Summary caching aggregates, e.g. ChunkAggregates, only the chunks at
+		/// either end of the range are read element by element.
+		/// @param first,last positions of the range
+		/// @throw std::out_of_range if the range does not lie within the container
+		value_type range_sum(size_type first, size_type last) const {
+			value_type result{};
+			reduce_range(first, last,
+				[&result](const Summary& summary) {
+					if constexpr (caches_aggregates)
+						result += summary.sum();
+				},
+				[&result](const value_type& value) { result += value; });
+			return result;
+		};
+
+		/// @brief Returns the smallest element at positions [first, last).
+		/// @param first,last positions of the range
+		/// @throw std::out_of_range if the range is empty or does not lie within
+		/// the container
+		value_type range_min(size_type first, size_type last) const {
+			return range_extreme(first, last, [](const Summary& summary) {
+				if constexpr (caches_aggregates)
+					return summary.min();
+				else
+					return value_type();
+				}, [](const value_type& a, const value_type& b) { return a < b; });
+		};
+
+		/// @brief Returns the largest element at positions [first, last).
+		/// @param first,last positions of the range
+		/// @throw std::out_of_range if the range is empty or does not lie within
+		/// the container
+		value_type range_max(size_type first, size_type last) const {
+			return range_extreme(first, last, [](const Summary& summary) {
+				if constexpr (caches_aggregates)
+					return summary.max();
+				else
+					return value_type();
+				}, [](const value_type& a, const value_type& b) { return b < a; });
+		};
+
+		/// @brief Marks every chunk summary as stale, so it is rebuilt before the
+		/// next range query. Needed after elements are written through references
+		/// or pointers obtained before the last range query, or straight into
+		/// chunk storage.
+		void invalidate_summaries() noexcept {
+			for (chunk_type* chunk = first_chunk; chunk != nullptr; chunk = chunk->next)
+				touch(chunk);
+		};
+
+		/// @brief Calls f(elements, summary) for every chunk in order, with the
+		/// elements of the chunk as a span and its summary, rebuilt first if
+		/// stale. f keeps the summary up to date with what it writes, e.g. by
+		/// calling summary.invalidate().
+		template <class F>
+		void for_each_chunk(F f) requires Summary::enabled {
+			if (list_size == 0)
+				return;
+			prefetcher ahead(first_chunk);
+			for (chunk_type* chunk = first_chunk; chunk != nullptr; chunk = chunk->next, ahead.step()) {
+				summary_of(chunk);
+				f(std::span<value_type>(chunk->list, chunk->num_of_elements), chunk->summary);
+			}
+		};
+
+		template <class F>
+		void for_each_chunk(F f) const requires Summary::enabled {
+			if (list_size == 0)
+				return;
+			prefetcher ahead(first_chunk);
+			for (chunk_type* chunk = first_chunk; chunk != nullptr; chunk = chunk->next, ahead.step()) {
+				f(std::span<const value_type>(chunk->list, chunk->num_of_elements), summary_of(chunk));
+			}
+		};
+
+		/// COMPARISIONS
+
+		/// @brief Checks if the contents of lhs and rhs are equal. Both chunk
+		/// chains are walked together; runs of integers, enums and pointers are
+		/// compared with memcmp.
+		/// @param lhs,rhs ChunkLists whose contents to compare
+		friend bool operator==(const ChunkList& lhs, const ChunkList& rhs) {
+			if (lhs.list_size != rhs.list_size)
+				return false;
+			return !zip_chunks(lhs, rhs, [](const value_type* l, const value_type* r, size_type count) {
+				if constexpr (bitwise_comparable_v<value_type>) {
+					return std::memcmp(l, r, count * sizeof(value_type)) != 0;
+				}
+				else if constexpr (std::is_floating_point_v<value_type>) {
+					// Blocks without an early exit, which the compiler vectorizes
+					constexpr size_type block = 64;
+					for (size_type i = 0; i < count; i += block) {
+						bool differ = false;
+						for (size_type j = i; j < std::min(count, i + block); j++)
+							differ |= l[j] != r[j];
+						if (differ)
+							return true;
+					}
+					return false;
+				}
+				else {
+					return !std::equal(l, l + count, r);
+				}
+			});
+		};
+
+		/// @brief Compares the contents of lhs and rhs lexicographically, a run of
+		/// elements shared by a chunk of each at a time. The relational operators
+		/// are rewritten from this one. Elements without operator<=> are
+		/// compared with operator<.
+		/// @param lhs,rhs ChunkLists whose contents to compare
+		friend auto operator<=>(const ChunkList& lhs, const ChunkList& rhs)
+			requires requires (const value_type& a) { a < a; }
+		{
+			using ordering = decltype(three_way(std::declval<const value_type&>(), std::declval<const value_type&>()));
+			ordering result = ordering::equivalent;
+			zip_chunks(lhs, rhs, [&result](const value_type* l, const value_type* r, size_type count) {
+				if constexpr (std::three_way_comparable<value_type>)
+					result = std::lexicographical_compare_three_way(l, l + count, r, r + count, std::compare_three_way());
+				else
+					result = std::lexicographical_compare_three_way(l, l + count, r, r + count, three_way);
+				return result != 0;
+			});
+			if (result != 0)
+				return result;
+			return static_cast<ordering>(lhs.list_size <=> rhs.list_size);
+		};
+
+		private:
+		/// @brief Walks the chunks of lhs and rhs together, calling visit with the
+		/// runs of elements both chunks share, over the length of the shorter
+		/// list. Stops when visit returns true.
+		/// @return true if visit stopped the walk.
+		template <class Visit>
+		static bool zip_chunks(const ChunkList& lhs, const ChunkList& rhs, Visit visit) {
+			chunk_type* l = lhs.first_chunk;
+			chunk_type* r = rhs.first_chunk;
+			prefetcher l_ahead(l), r_ahead(r);
+			size_type l_offset = 0, r_offset = 0;
+			for (size_type remaining = std::min(lhs.list_size, rhs.list_size); remaining > 0;) {
+				size_type count = std::min(l->num_of_elements - l_offset, r->num_of_elements - r_offset);
+				if (visit(l->list + l_offset, r->list + r_offset, count))
+					return true;
+				remaining -= count;
+				l_offset += count;
+				r_offset += count;
+				if (l_offset == l->num_of_elements) {
+					l = l->next;
+					l_offset = 0;
+					l_ahead.step();
+				}
+				if (r_offset == r->num_of_elements) {
+					r = r->next;
+					r_offset = 0;
+					r_ahead.step();
+				}
+			}
+			return false;
+		}
+
+		/// @brief Three-way comparison of two elements, through operator<=> when
+		/// there is one and operator< otherwise.
+		static auto three_way(const value_type& a, const value_type& b) {
+			if constexpr (std::three_way_comparable<value_type>) {
+				return a <=> b;
+			}
+			else {
+				if (a < b)
+					return std::weak_ordering::less;
+				if (b < a)
+					return std::weak_ordering::greater;
+				return std::weak_ordering::equivalent;
+			}
+		}
+	};
+
+	// Without CHUNKLIST_ENABLE_STATS the counters take no space: the list is the
+	// interface pointer, its four links and sizes, and one word shared by the
+	// empty size policy, allocator and inline chunk
+	static_assert(stats_enabled || sizeof(ChunkList<int>) == sizeof(void*) + 5 * sizeof(std::size_t),
+		"Disabled statistics must not grow the list object");
+
+	/// @brief ChunkList whose chunk size is chosen at construction.
+	template <typename T, std::size_t N, typename Allocator = Allocator<T>>
+	using RuntimeChunkList = ChunkList<T, N, Allocator, RuntimeChunkSize<N>>;
+
+	/// @brief ChunkList whose chunks double in size from N up to Cap.
+	template <typename T, std::size_t N, std::size_t Cap = N * 64, typename Allocator = Allocator<T>>
+	using GeometricChunkList = ChunkList<T, N, Allocator, GeometricChunkSize<N, Cap>>;
+
+	/// @brief ChunkList keeping its first InlineN elements inside the list object.
+	template <typename T, std::size_t InlineN, std::size_t N = default_chunk_size<T>(), typename Allocator = Allocator<T>>
+	using SmallChunkList = ChunkList<T, N, Allocator, FixedChunkSize<N>, InlineN>;
+
+	/// SEGMENTED RANGES
+
+	/// @brief A range that can also be walked as a range of contiguous segments,
+	/// e.g. ChunkList through segments().
+	template <class R>
+	concept segmented_range = std::ranges::range<R> && requires (R& r) {
+		{ r.segments() } -> std::ranges::forward_range;
+		requires std::ranges::contiguous_range<std::ranges::range_reference_t<decltype(r.segments())>>;
+	};
+
+	/// @brief Calls f with every element of r in order. A segmented range is
+	/// walked a segment at a time with plain pointers, so there is no check for
+	/// a chunk boundary on every element.
+	/// @param r range to walk
+	/// @param f callable taking an element
+	template <std::ranges::input_range R, class F>
+	void for_each_segmented(R&& r, F f) {
+		if constexpr (segmented_range<R>) {
+			for (auto segment : r.segments())
+				for (auto& el : segment)
+					f(el);
+		}
+		else {
+			for (auto&& el : r)
+				f(el);
+		}
+	}
+
+	/// @brief Applies a view pipeline, e.g. std::views::filter(p) |
+	/// std::views::transform(t), to r and calls f with every resulting element
+	/// in order. For a segmented range the pipeline runs over each segment in
+	/// turn, which is a contiguous range.
+	/// @param r range to walk
+	/// @param adaptor range adaptor to apply
+	/// @param f callable taking an element of the adapted range
+	template <std::ranges::input_range R, class Adaptor, class F>
+	void for_each_segmented(R&& r, Adaptor adaptor, F f) {
+		if constexpr (segmented_range<R>) {
+			for (auto segment : r.segments())
+				for (auto&& el : segment | adaptor)
+					f(el);
+		}
+		else {
+			for (auto&& el : std::forward<R>(r) | adaptor)
+				f(el);
+		}
+	}
+
+	/// NON-MEMBER FUNCTIONS
+
+	/// @brief  Swaps the contents of lhs and rhs.
+	/// @param lhs,rhs containers whose contents to swap
+	template <class T, std::size_t N, class Alloc, class SizePolicy, std::size_t InlineN, class Summary>
+	void swap(ChunkList<T, N, Alloc, SizePolicy, InlineN, Summary>& lhs, ChunkList<T, N, Alloc, SizePolicy, InlineN, Summary>& rhs) {
+		lhs.swap(rhs);
+	}
+
+	/// @brief Erases all elements that compare equal to value from the container.
+	/// @param c container from which to erase
+	/// @param value value to be removed
+	/// @return The number of erased elements.
+	template <class T, std::size_t N, class Alloc, class SizePolicy, std::size_t InlineN, class Summary, class U>
+	typename ChunkList<T, N, Alloc, SizePolicy, InlineN, Summary>::size_type erase(ChunkList<T, N, Alloc, SizePolicy, InlineN, Summary>& c, const U& value) {
+		return c.remove(value);
+	}
+
+	/// @brief Erases all elements that satisfy pred from the container.
+	/// @param c container from which to erase
+	/// @param pred unary predicate which returns true if the element should be
+	/// erased.
+	/// @return The number of erased elements.
+	template <class T, std::size_t N, class Alloc, class SizePolicy, std::size_t InlineN, class Summary, class Pred>
+	typename ChunkList<T, N, Alloc, SizePolicy, InlineN, Summary>::size_type erase_if(ChunkList<T, N, Alloc, SizePolicy, InlineN, Summary>& c, Pred pred) {
+		return c.remove_if(pred);
+	}
+}  // namespace fefu_laboratory_two
+
+namespace std {
+	/// @brief Hashes the elements of a ChunkList in order, so lists that compare
+	/// equal hash the same. Integers, enums and pointers are hashed as bytes a
+	/// chunk at a time; other elements are combined through their std::hash.
+	template <typename T, std::size_t N, typename Allocator, typename SizePolicy, std::size_t InlineN, typename Summary>
+	struct hash<fefu_laboratory_two::ChunkList<T, N, Allocator, SizePolicy, InlineN, Summary>> {
+		std::size_t operator()(const fefu_laboratory_two::ChunkList<T, N, Allocator, SizePolicy, InlineN, Summary>& list) const {
+			fefu_laboratory_two::StreamHash hash;
+			for (auto segment : list.segments())
+				hash.update_elements(segment.data(), segment.data() + segment.size());
+			return static_cast<std::size_t>(hash.digest());
+		}
+	};
+}  // namespace std
+
+#include "ChunkListBool.h"
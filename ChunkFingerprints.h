@@ -0,0 +1,119 @@
+#pragma once
+#include "Chunk.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+
+namespace fefu_laboratory_two {
+	/// @brief Chunk summary caching a hash of the elements of a chunk. Any write
+	/// to the chunk makes it stale, and it is recomputed the next time it is
+	/// read, so hashing a list again only reads the chunks written since.
+	/// @tparam T type of the elements
+	/// @tparam Hash hash function object for one element
+	template <typename T, class Hash = std::hash<T>>
+	struct ChunkFingerprint {
+		static constexpr bool enabled = true;
+
+		std::uint64_t hash = 0;
+		bool is_stale = true;
+
+		void add(const T&) noexcept { is_stale = true; }
+
+		void remove(const T&) noexcept { is_stale = true; }
+
+		void invalidate() noexcept { is_stale = true; }
+
+		bool stale() const noexcept { return is_stale; }
+
+		void rebuild(const T* first, const T* last) {
+			StreamHash stream;
+			stream.update_elements(first, last, Hash());
+			hash = stream.digest();
+			is_stale = false;
+		}
+
+		std::uint64_t value() const noexcept { return hash; }
+	};
+
+	/// @brief Returns a hash of the contents of list built from the cached
+	/// hashes of its chunks, rehashing only the chunks written since the last
+	/// call. Lists with equal contents and the same chunk capacity have equal
+	/// fingerprints; different fingerprints prove the contents differ.
+	/// @param list ChunkList keeping a ChunkFingerprint per chunk, e.g.
+	/// FingerprintedChunkList
+	template <class List>
+	std::uint64_t fingerprint(const List& list) {
+		StreamHash stream;
+		list.for_each_chunk([&stream](std::span<const typename List::value_type>, const auto& chunk) {
+			stream.update_word(chunk.value());
+		});
+		stream.update_word(list.size());
+		return stream.digest();
+	}
+
+	/// @brief Content-addressed store of chunk payloads. A snapshot keeps a
+	/// list as a sequence of shared, immutable payloads looked up by chunk
+	/// fingerprint, so chunks that are identical across lists or across
+	/// versions of one list are stored once.
+	/// @tparam List ChunkList keeping a ChunkFingerprint per chunk, e.g.
+	/// FingerprintedChunkList
+	template <class List>
+	class ChunkDedupStore {
+	public:
+		using value_type = typename List::value_type;
+		using size_type = std::size_t;
+		using payload = std::shared_ptr<const std::vector<value_type>>;
+		using snapshot_type = std::vector<payload>;
+
+		/// @brief Returns the chunks of list as payloads of the store, adding
+		/// the ones it does not hold yet. Payloads with a matching fingerprint
+		/// are compared element by element before they are shared.
+		snapshot_type snapshot(const List& list) {
+			snapshot_type result;
+			list.for_each_chunk([this, &result](std::span<const value_type> elements, const auto& chunk) {
+				result.push_back(intern(chunk.value(), elements));
+			});
+			return result;
+		}
+
+		/// @brief Builds a list holding the elements of a snapshot.
+		static List restore(const snapshot_type& snapshot) {
+			List list;
+			for (const payload& chunk : snapshot)
+				for (const value_type& el : *chunk)
+					list.push_back(el);
+			return list;
+		}
+
+		/// @brief Returns the number of distinct payloads held.
+		size_type payload_count() const noexcept { return payloads.size(); }
+
+		/// @brief Drops the payloads that no snapshot refers to anymore.
+		void collect() {
+			std::erase_if(payloads, [](const auto& entry) { return entry.second.use_count() == 1; });
+		}
+
+	private:
+		payload intern(std::uint64_t hash, std::span<const value_type> elements) {
+			auto [first, last] = payloads.equal_range(hash);
+			for (; first != last; ++first)
+				if (std::ranges::equal(*first->second, elements))
+					return first->second;
+			payload chunk = std::make_shared<const std::vector<value_type>>(elements.begin(), elements.end());
+			payloads.emplace(hash, chunk);
+			return chunk;
+		}
+
+		std::unordered_multimap<std::uint64_t, payload> payloads;
+	};
+
+	/// @brief ChunkList caching a ChunkFingerprint per chunk, for fingerprint()
+	/// and ChunkDedupStore.
+	template <typename T, std::size_t N = default_chunk_size<T>(), class Hash = std::hash<T>,
+		typename Allocator = Allocator<T>>
+	using FingerprintedChunkList = ChunkList<T, N, Allocator, FixedChunkSize<N>, 0, ChunkFingerprint<T, Hash>>;
+}  // namespace fefu_laboratory_two
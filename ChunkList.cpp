@@ -1,342 +1,2020 @@
-#include "pch.h"
-#include "CppUnitTest.h"
-#include "Chunk.h"
-#include <vector>
-
-using namespace fefu_laboratory_two;
-using namespace Microsoft::VisualStudio::CppUnitTestFramework;
-
-namespace ChunkListUnitTest
-{
-	TEST_CLASS(ConstructorTests)
-	{
-	public:
-		TEST_METHOD(DefaultConstructorTest)
-		{
-			ChunkList<int, 8> list;
-			Assert::IsTrue(list.empty() == true);
-			Assert::IsTrue(list.size() == 0);
-		}
-
-		TEST_METHOD(FromChunkListConstructor)
-		{
-			ChunkList<int, 8> list;
-			for (int i = 0; i < 8; i++) {
-				list.push_back(i);
-			}
-			auto list2 = list;
-			Assert::IsTrue(list == list2);
-		}
-
-		TEST_METHOD(FromInitListConstructor)
-		{
-			ChunkList<int, 4> list;
-			for (int i = 0; i < 4; i++) {
-				list.push_back(i);
-			}
-			ChunkList<int, 4> list2 = { 0, 1, 2, 3 };
-			Assert::IsTrue(list == list2);
-		}
-
-		TEST_METHOD(FromRangeConstructor)
-		{
-			ChunkList<int, 4> list;
-			std::vector<int> range;
-			for (int i = 0; i < 4; i++) {
-				list.push_back(i);
-				range.push_back(i);
-			}
-			ChunkList<int, 4> list2(range.begin(), range.end());
-			Assert::IsTrue(list == list2);
-		}
-
-		TEST_METHOD(Assign)
-		{
-			ChunkList<int, 8> list;
-			ChunkList<int, 8> list2;
-			for (int i = 0; i < 8; i++) {
-				list.push_back(2);
-			}
-			list2.assign(8, 2);
-
-			Assert::IsTrue(list == list2);
-		}
-
-		TEST_METHOD(AssignIt)
-		{
-			ChunkList<int, 8> list;
-			ChunkList<int, 8> list2;
-			std::vector<int> v;
-			for (int i = 0; i < 8; i++) {
-				list.push_back(2);
-				v.push_back(2);
-			}
-			list2.assignIt(v.begin(), v.end());
-
-			Assert::IsTrue(list == list2);
-		}
-
-		TEST_METHOD(AssignFromInitList)
-		{
-			ChunkList<int, 4> list;
-			ChunkList<int, 4> list2;
-			for (int i = 0; i < 4; i++) {
-				list.push_back(i);
-			}
-			list2.assign({ 0, 1, 2, 3 });
-
-			Assert::IsTrue(list == list2);
-		}
-	};
-
-	TEST_CLASS(COMPARISIONSTests)
-	{
-	public:
-		TEST_METHOD(SpaceshipOperator)
-		{
-			ChunkList<int, 8> list;
-			ChunkList<int, 8> list2;
-			for (int i = 0; i < 8; i++) {
-				list.push_back(2);
-				list2.push_back(2);
-			}
-
-			auto res = list <=> list2;
-			Assert::IsTrue(res == std::strong_ordering::equal);
-		}
-
-		TEST_METHOD(EquelOperator)
-		{
-			ChunkList<int, 8> list;
-			ChunkList<int, 8> list2;
-			for (int i = 0; i < 8; i++) {
-				list.push_back(2);
-				list2.push_back(2);
-			}
-
-			auto res = list == list2;
-			Assert::IsTrue(res);
-		}
-
-		TEST_METHOD(NotEquelOperator)
-		{
-			ChunkList<int, 8> list;
-			ChunkList<int, 8> list2;
-			for (int i = 0; i < 8; i++) {
-				list.push_back(2);
-				list2.push_back(3);
-			}
-
-			auto res = list != list2;
-			Assert::IsTrue(res);
-		}
-
-		TEST_METHOD(LessOperator)
-		{
-			ChunkList<int, 8> list;
-			ChunkList<int, 8> list2;
-			for (int i = 0; i < 8; i++) {
-				list.push_back(2);
-				list2.push_back(3);
-			}
-
-			auto res = list < list2;
-			Assert::IsTrue(res);
-		}
-
-		TEST_METHOD(GreaterOperator)
-		{
-			ChunkList<int, 8> list;
-			ChunkList<int, 8> list2;
-			for (int i = 0; i < 8; i++) {
-				list.push_back(3);
-				list2.push_back(2);
-			}
-
-			auto res = list > list2;
-			Assert::IsTrue(res);
-		}
-	};
-
-	TEST_CLASS(ElementAccessTests)
-	{
-	public:
-		TEST_METHOD(At)
-		{
-			ChunkList<int, 8> list;
-			for (int i = 0; i < 30; i++) {
-				list.push_back(i);
-			}
-			Assert::IsTrue(list.at(0) == 0);
-			Assert::IsTrue(list.at(15) == 15);
-			Assert::ExpectException<std::out_of_range>([]() {
-				ChunkList<int, 8> l;
-				l.at(31);
-				});
-		}
-
-		TEST_METHOD(OperatorBrackets)
-		{
-			ChunkList<int, 8> list;
-			for (int i = 0; i < 30; i++) {
-				list.push_back(i);
-			}
-			Assert::IsTrue(list[0] == 0);
-			Assert::IsTrue(list[15] == 15);
-		}
-	};
-
-	TEST_CLASS(IteratorTests) {
-		TEST_METHOD(Iterators) {
-			ChunkList<int, 8> list;
-			int* arr = new int[15];
-			for (int i = 0; i < 15; i++) {
-				list.push_back(i);
-				arr[i] = i;
-			}
-
-			int j = 0;
-			for (auto e : list)
-				Assert::IsTrue(arr[j++] == e);
-
-			auto it1 = list.begin();
-			auto it2 = list.begin();
-			Assert::IsTrue(it1 == it2);
-			Assert::IsTrue(it1 >= it2);
-			it2++;
-			Assert::IsTrue(it2 > it1);
-			it1 += 3;
-			Assert::IsFalse(it1 < it2);
-		}
-	};
-
-	TEST_CLASS(CapacityTests) {
-		TEST_METHOD(CapacityMethods) {
-			ChunkList<int, 8> list;
-			Assert::IsTrue(list.empty() == true);
-			Assert::IsTrue(list.size() == 0);
-			Assert::IsTrue(list.max_size() == 0);
-			for (int i = 0; i < 9; i++) {
-				list.push_back(i);
-			}
-			Assert::IsTrue(list.size() == 9);
-			Assert::IsTrue(list.max_size() == 16);
-		}
-	};
-
-	TEST_CLASS(MODIFIERSTests) {
-		TEST_METHOD(Insert) {
-			ChunkList<int, 8> list;
-			ChunkList<int, 8> list2;
-			list2.push_back(100);
-			list2.push_back(0);
-			list2.push_back(1);
-			list2.push_back(2);
-
-			for (int i = 0; i < 10; i++)
-				list.push_back(i);
-
-			list.clear();
-
-			Assert::IsTrue(list.empty() == true);
-			Assert::IsTrue(list.size() == 0);
-			Assert::IsTrue(list.max_size() == 0);
-
-			for (int i = 0; i < 3; i++)
-				list.push_back(i);
-
-			auto it = list.cbegin();
-			list.insert(it, 100);
-
-			Assert::IsTrue(list == list2);
-		}
-
-		TEST_METHOD(Erase) {
-			ChunkList<int, 8> list;
-			ChunkList<int, 8> list2;
-
-			for (int i = 1; i < 8; i++)
-				list2.push_back(i);
-
-
-			for (int i = 0; i < 8; i++)
-				list.push_back(i);
-
-			list.erase(list.cbegin());
-
-			Assert::IsTrue(list == list2);
-		}
-
-		TEST_METHOD(PushAndPop) {
-			ChunkList<int, 8> list;
-
-			for (int i = 0; i < 8; i++)
-				list.push_back(i);
-
-			Assert::IsTrue(list[0] == 0);
-			Assert::IsTrue(list[7] == 7);
-
-			list.pop_back();
-			Assert::IsTrue(list.size() == 7);
-
-			list.push_front(350);
-			Assert::IsTrue(list[0] == 350);
-
-			list.pop_front();
-			Assert::IsTrue(list[0] == 0);
-		}
-
-		TEST_METHOD(Emplace) {
-			ChunkList<int, 8> list;
-
-			for (int i = 0; i < 8; i++)
-				list.push_back(i);
-
-			list.emplace_back(10);
-			list.emplace_front(22);
-
-			Assert::IsTrue(list[0] == 22);
-			Assert::IsTrue(list[9] == 10);
-		}
-	};
-
-	TEST_CLASS(RestructureTests) {
-		TEST_METHOD(Resize) {
-			ChunkList<int, 4> list;
-			auto list2 = list;
-
-			for (int i = 0; i < 4; i++)
-				list.push_back(i);
-
-			list.resize(3);
-
-			list2.push_back(0);
-			list2.push_back(1);
-			list2.push_back(2);
-
-			Assert::IsTrue(list == list2);
-		}
-	};
-
-	TEST_CLASS(SwapTests) {
-		TEST_METHOD(Swap) {
-			ChunkList<int, 4> list;
-			auto list2 = list;
-			auto list3 = list;
-
-			for (int i = 0; i < 4; i++) {
-				list.push_back(1);
-				list2.push_back(2);
-				list3.push_back(2);
-			}
-
-			Assert::IsTrue(list != list2);
-			Assert::IsTrue(list2 == list3);
-
-			list.swap(list2);
-
-			Assert::IsTrue(list == list3);
-			Assert::IsTrue(list2 != list3);
-		}
-	};
-}
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "Chunk.h"
+#include "ChunkFingerprints.h"
+#include "ChunkListDelta.h"
+#include "ChunkListIO.h"
+#include "ChunkSummaries.h"
+#include "ColumnChunkList.h"
+#include "SortedChunkList.h"
+#include "CompressedChunkList.h"
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#ifndef _WIN32
+#include "MappedChunkList.h"
+#include "SharedChunkList.h"
+#include "SpillChunkList.h"
+#include <fcntl.h>
+#include <sys/wait.h>
+#endif
+
+using namespace fefu_laboratory_two;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ChunkListUnitTest
+{
+	TEST_CLASS(ConstructorTests)
+	{
+	public:
+		TEST_METHOD(DefaultConstructorTest)
+		{
+			ChunkList<int, 8> list;
+			Assert::IsTrue(list.empty() == true);
+			Assert::IsTrue(list.size() == 0);
+		}
+
+		TEST_METHOD(FromChunkListConstructor)
+		{
+			ChunkList<int, 8> list;
+			for (int i = 0; i < 8; i++) {
+				list.push_back(i);
+			}
+			auto list2 = list;
+			Assert::IsTrue(list == list2);
+		}
+
+		TEST_METHOD(FromInitListConstructor)
+		{
+			ChunkList<int, 4> list;
+			for (int i = 0; i < 4; i++) {
+				list.push_back(i);
+			}
+			ChunkList<int, 4> list2 = { 0, 1, 2, 3 };
+			Assert::IsTrue(list == list2);
+		}
+
+		TEST_METHOD(FromRangeConstructor)
+		{
+			ChunkList<int, 4> list;
+			std::vector<int> range;
+			for (int i = 0; i < 4; i++) {
+				list.push_back(i);
+				range.push_back(i);
+			}
+			ChunkList<int, 4> list2(range.begin(), range.end());
+			Assert::IsTrue(list == list2);
+		}
+
+		TEST_METHOD(Assign)
+		{
+			ChunkList<int, 8> list;
+			ChunkList<int, 8> list2;
+			for (int i = 0; i < 8; i++) {
+				list.push_back(2);
+			}
+			list2.assign(8, 2);
+
+			Assert::IsTrue(list == list2);
+		}
+
+		TEST_METHOD(AssignIt)
+		{
+			ChunkList<int, 8> list;
+			ChunkList<int, 8> list2;
+			std::vector<int> v;
+			for (int i = 0; i < 8; i++) {
+				list.push_back(2);
+				v.push_back(2);
+			}
+			list2.assignIt(v.begin(), v.end());
+
+			Assert::IsTrue(list == list2);
+		}
+
+		TEST_METHOD(AssignFromInitList)
+		{
+			ChunkList<int, 4> list;
+			ChunkList<int, 4> list2;
+			for (int i = 0; i < 4; i++) {
+				list.push_back(i);
+			}
+			list2.assign({ 0, 1, 2, 3 });
+
+			Assert::IsTrue(list == list2);
+		}
+	};
+
+	TEST_CLASS(COMPARISIONSTests)
+	{
+	public:
+		TEST_METHOD(SpaceshipOperator)
+		{
+			ChunkList<int, 8> list;
+			ChunkList<int, 8> list2;
+			for (int i = 0; i < 8; i++) {
+				list.push_back(2);
+				list2.push_back(2);
+			}
+
+			auto res = list <=> list2;
+			Assert::IsTrue(res == std::strong_ordering::equal);
+		}
+
+		TEST_METHOD(EquelOperator)
+		{
+			ChunkList<int, 8> list;
+			ChunkList<int, 8> list2;
+			for (int i = 0; i < 8; i++) {
+				list.push_back(2);
+				list2.push_back(2);
+			}
+
+			auto res = list == list2;
+			Assert::IsTrue(res);
+		}
+
+		TEST_METHOD(NotEquelOperator)
+		{
+			ChunkList<int, 8> list;
+			ChunkList<int, 8> list2;
+			for (int i = 0; i < 8; i++) {
+				list.push_back(2);
+				list2.push_back(3);
+			}
+
+			auto res = list != list2;
+			Assert::IsTrue(res);
+		}
+
+		TEST_METHOD(LessOperator)
+		{
+			ChunkList<int, 8> list;
+			ChunkList<int, 8> list2;
+			for (int i = 0; i < 8; i++) {
+				list.push_back(2);
+				list2.push_back(3);
+			}
+
+			auto res = list < list2;
+			Assert::IsTrue(res);
+		}
+
+		TEST_METHOD(GreaterOperator)
+		{
+			ChunkList<int, 8> list;
+			ChunkList<int, 8> list2;
+			for (int i = 0; i < 8; i++) {
+				list.push_back(3);
+				list2.push_back(2);
+			}
+
+			auto res = list > list2;
+			Assert::IsTrue(res);
+		}
+
+		TEST_METHOD(Lexicographic)
+		{
+			ChunkList<int, 8> longer, shorter;
+			for (int i = 0; i < 20; i++)
+				longer.push_back(i);
+			shorter.push_back(1);
+			Assert::IsTrue(longer < shorter && shorter > longer);
+			Assert::IsTrue(longer >= longer && longer <= longer);
+
+			ChunkList<int, 8> prefix(longer);
+			prefix.pop_back();
+			Assert::IsTrue(prefix < longer && prefix != longer);
+			prefix.push_back(19);
+			Assert::IsTrue((prefix <=> longer) == std::strong_ordering::equal);
+			prefix[13] = -1;
+			Assert::IsTrue(prefix < longer && !(prefix == longer));
+
+			RuntimeChunkList<int, 8> three(RuntimeChunkSize<8>(3)), five(RuntimeChunkSize<8>(5));
+			for (int i = 0; i < 17; i++) {
+				three.push_back(i);
+				five.push_back(i);
+			}
+			Assert::IsTrue(three == five);
+			five.back() = 100;
+			Assert::IsTrue(three < five);
+
+			ChunkList<double, 8> nan{ 1.0, std::nan("") }, same{ 1.0, std::nan("") };
+			Assert::IsTrue(nan != same);
+			Assert::IsTrue((nan <=> same) == std::partial_ordering::unordered);
+
+			struct LessOnly {
+				int key;
+				bool operator<(const LessOnly& other) const { return key < other.key; }
+				bool operator==(const LessOnly& other) const { return key == other.key; }
+			};
+			ChunkList<LessOnly, 4> a{ { 1 }, { 2 } }, b{ { 1 }, { 3 } };
+			Assert::IsTrue((a <=> b) == std::weak_ordering::less);
+		}
+
+		TEST_METHOD(Hash)
+		{
+			RuntimeChunkList<int, 8> three(RuntimeChunkSize<8>(3)), five(RuntimeChunkSize<8>(5));
+			for (int i = 0; i < 23; i++) {
+				three.push_back(i);
+				five.push_back(i);
+			}
+			using Hash = std::hash<RuntimeChunkList<int, 8>>;
+			Assert::IsTrue(Hash()(three) == Hash()(five));
+			five.back() = 0;
+			Assert::IsTrue(Hash()(three) != Hash()(five));
+
+			std::unordered_set<ChunkList<std::string, 4>> keys;
+			keys.insert({ "a", "b", "c", "d", "e" });
+			keys.insert({ "a", "b", "c", "d", "e" });
+			keys.insert({ "a", "b" });
+			Assert::IsTrue(keys.size() == 2 && keys.contains({ "a", "b" }));
+		}
+	};
+
+	TEST_CLASS(ElementAccessTests)
+	{
+	public:
+		TEST_METHOD(At)
+		{
+			ChunkList<int, 8> list;
+			for (int i = 0; i < 30; i++) {
+				list.push_back(i);
+			}
+			Assert::IsTrue(list.at(0) == 0);
+			Assert::IsTrue(list.at(15) == 15);
+			Assert::ExpectException<std::out_of_range>([]() {
+				ChunkList<int, 8> l;
+				l.at(31);
+				});
+		}
+
+		TEST_METHOD(OperatorBrackets)
+		{
+			ChunkList<int, 8> list;
+			for (int i = 0; i < 30; i++) {
+				list.push_back(i);
+			}
+			Assert::IsTrue(list[0] == 0);
+			Assert::IsTrue(list[15] == 15);
+		}
+	};
+
+	TEST_CLASS(IteratorTests) {
+		TEST_METHOD(Iterators) {
+			ChunkList<int, 8> list;
+			int* arr = new int[15];
+			for (int i = 0; i < 15; i++) {
+				list.push_back(i);
+				arr[i] = i;
+			}
+
+			int j = 0;
+			for (auto e : list)
+				Assert::IsTrue(arr[j++] == e);
+
+			auto it1 = list.begin();
+			auto it2 = list.begin();
+			Assert::IsTrue(it1 == it2);
+			Assert::IsTrue(it1 >= it2);
+			it2++;
+			Assert::IsTrue(it2 > it1);
+			it1 += 3;
+			Assert::IsFalse(it1 < it2);
+		}
+
+		static_assert(std::random_access_iterator<ChunkList<int, 8>::iterator>);
+		static_assert(std::random_access_iterator<ChunkList<int, 8>::const_iterator>);
+		static_assert(std::ranges::random_access_range<ChunkList<int, 8>>);
+		static_assert(std::ranges::random_access_range<const ChunkList<int, 8>>);
+		static_assert(std::ranges::sized_range<ChunkList<int, 8>>);
+		static_assert(std::ranges::common_range<ChunkList<int, 8>>);
+		static_assert(segmented_range<ChunkList<int, 8>>);
+		static_assert(!segmented_range<std::vector<int>>);
+
+		TEST_METHOD(RandomAccessAcrossChunks) {
+			ChunkList<int, 8> list;
+			Assert::IsTrue(list.begin() == list.end());
+			for (int i = 0; i < 50; i++)
+				list.push_back(49 - i);
+
+			auto last = list.end();
+			--last;
+			Assert::IsTrue(*last == 0);
+			Assert::IsTrue(list.end() - list.begin() == 50);
+			Assert::IsTrue(list.begin()[17] == 32);
+			Assert::IsTrue(*(list.end() - 9) == 8);
+			auto it = list.begin() + 30;
+			it -= 23;
+			Assert::IsTrue(*it == 42);
+			ChunkList<int, 8>::const_iterator cit = it;
+			Assert::IsTrue(cit == it);
+			Assert::IsTrue(*std::prev(std::ranges::end(std::as_const(list))) == 0);
+
+			std::ranges::sort(list);
+			for (int i = 0; i < 50; i++)
+				Assert::IsTrue(list[i] == i);
+			std::reverse(list.begin(), list.end());
+			Assert::IsTrue(list.front() == 49 && list.back() == 0);
+			Assert::IsTrue(std::ranges::equal(list | std::views::reverse | std::views::take(3), std::vector<int>{ 0, 1, 2 }));
+			Assert::IsTrue(*std::ranges::lower_bound(list, 10, std::greater<int>()) == 10);
+		}
+
+		TEST_METHOD(SegmentedPipelines) {
+			ChunkList<int, 8> list;
+			for (int i = 0; i < 100; i++)
+				list.push_back(i);
+
+			auto pipeline = std::views::filter([](int v) { return v % 3 == 0; })
+				| std::views::transform([](int v) { return v * 2; });
+			std::vector<int> flat;
+			for (int v : list | pipeline)
+				flat.push_back(v);
+			std::vector<int> segmented;
+			for_each_segmented(list, pipeline, [&segmented](int v) { segmented.push_back(v); });
+			Assert::IsTrue(flat == segmented);
+			Assert::IsTrue(flat.size() == 34 && flat.back() == 198);
+
+			std::size_t chunks = 0;
+			for (std::span<const int> segment : std::as_const(list).segments()) {
+				Assert::IsTrue(segment.size() <= 8);
+				chunks++;
+			}
+			Assert::IsTrue(chunks == list.chunk_count());
+			long long sum = 0;
+			for_each_segmented(list, [&sum](int v) { sum += v; });
+			Assert::IsTrue(sum == 4950);
+			Assert::IsTrue(std::ranges::equal(list.segments() | std::views::join, list));
+		}
+
+		TEST_METHOD(SteppingAcrossChunks) {
+			ChunkList<int, 8> list;
+			std::vector<int> expected;
+			for (int i = 0; i < 70; i++) {
+				list.push_front(i);
+				expected.insert(expected.begin(), i);
+			}
+
+			for (std::size_t distance : { 0, 1, 4, 100 }) {
+				prefetch_distance = distance;
+				Assert::IsTrue(std::ranges::equal(list, expected));
+				Assert::IsTrue(std::ranges::equal(list | std::views::reverse, expected | std::views::reverse));
+				Assert::IsTrue(std::ranges::equal(list.segments() | std::views::join, expected));
+				Assert::IsTrue(list.count_in_range(10, 19) == 10);
+			}
+			prefetch_distance = 2;
+
+			auto it = list.begin() + 7;
+			++it;
+			Assert::IsTrue(*it == 61);
+			--it;
+			--it;
+			Assert::IsTrue(*it == 63);
+			it += 20;
+			++it;
+			Assert::IsTrue(*it == 42);
+			ChunkList<int, 8>::const_iterator cit = it;
+			for (int i = 0; i < 30; i++)
+				++cit;
+			Assert::IsTrue(*cit == 12);
+			for (int i = 0; i < 40; i++)
+				--cit;
+			Assert::IsTrue(*cit == 52);
+
+			auto last = list.end();
+			for (int i = 0; i < 9; i++)
+				--last;
+			Assert::IsTrue(*last == 8);
+			for (int i = 0; i < 9; i++)
+				++last;
+			Assert::IsTrue(last == list.end());
+		}
+	};
+
+	TEST_CLASS(CapacityTests) {
+		TEST_METHOD(CapacityMethods) {
+			ChunkList<int, 8> list;
+			Assert::IsTrue(list.empty() == true);
+			Assert::IsTrue(list.size() == 0);
+			Assert::IsTrue(list.max_size() == 0);
+			for (int i = 0; i < 9; i++) {
+				list.push_back(i);
+			}
+			Assert::IsTrue(list.size() == 9);
+			Assert::IsTrue(list.max_size() == 16);
+		}
+	};
+
+	TEST_CLASS(MODIFIERSTests) {
+		TEST_METHOD(Insert) {
+			ChunkList<int, 8> list;
+			ChunkList<int, 8> list2;
+			list2.push_back(100);
+			list2.push_back(0);
+			list2.push_back(1);
+			list2.push_back(2);
+
+			for (int i = 0; i < 10; i++)
+				list.push_back(i);
+
+			list.clear();
+
+			Assert::IsTrue(list.empty() == true);
+			Assert::IsTrue(list.size() == 0);
+			Assert::IsTrue(list.max_size() == 0);
+
+			for (int i = 0; i < 3; i++)
+				list.push_back(i);
+
+			auto it = list.cbegin();
+			list.insert(it, 100);
+
+			Assert::IsTrue(list == list2);
+		}
+
+		template <class List>
+		static void check_range_insert(List list) {
+			std::vector<int> expected;
+			std::mt19937 rng(9);
+			for (int round = 0; round < 200; round++) {
+				std::size_t index = expected.empty() ? 0 : rng() % (expected.size() + 1);
+				std::size_t count = (round % 3 == 0 ? 8 * (rng() % 4) : rng() % 20);
+				std::vector<int> incoming;
+				for (std::size_t i = 0; i < count; i++)
+					incoming.push_back(round * 100 + static_cast<int>(i));
+				auto it = round % 2 == 0
+					? list.insert(list.cbegin() + index, incoming.begin(), incoming.end())
+					: list.insert(list.cbegin() + index, count, round);
+				if (round % 2 == 0)
+					expected.insert(expected.begin() + index, incoming.begin(), incoming.end());
+				else
+					expected.insert(expected.begin() + index, count, round);
+				Assert::IsTrue(it.get_index() == static_cast<std::ptrdiff_t>(index));
+				Assert::IsTrue(list.size() == expected.size());
+			}
+			Assert::IsTrue(std::ranges::equal(list, expected));
+			Assert::IsTrue(list.count_in_range(500, 5000) == static_cast<std::size_t>(std::count_if(expected.begin(), expected.end(),
+				[](int v) { return 500 <= v && v <= 5000; })));
+			list.push_back(-1);
+			Assert::IsTrue(list.back() == -1 && list.size() == expected.size() + 1);
+		}
+
+		TEST_METHOD(RangeInsert) {
+			check_range_insert(ChunkList<int, 8>());
+			check_range_insert(RuntimeChunkList<int, 8>(RuntimeChunkSize<8>(8)));
+			check_range_insert(GeometricChunkList<int, 4, 32>());
+			check_range_insert(SmallChunkList<int, 5, 8>());
+			check_range_insert(ZoneMappedChunkList<int, 8>());
+
+			ChunkList<int, 4> list = { 1, 2, 3, 4, 5, 6, 7, 8 };
+			const int* moved = &list[4];
+			list.insert(list.cbegin() + 2, 4, 0);
+			Assert::IsTrue(list == ChunkList<int, 4>({ 1, 2, 0, 0, 0, 0, 3, 4, 5, 6, 7, 8 }));
+			Assert::IsTrue(list.chunk_count() == 3);
+			// A whole chunk was spliced in, the following chunk did not move
+			Assert::IsTrue(&list[8] == moved);
+			list.insert(list.cend(), { 9, 10 });
+			list.insert(list.cbegin(), { -1 });
+			Assert::IsTrue(list.front() == -1 && list.back() == 10 && list.size() == 15);
+
+			std::istringstream input("20 21 22 23 24");
+			list.insert(list.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+			Assert::IsTrue(list[1] == 20 && list[5] == 24 && list[6] == 1);
+			Assert::ExpectException<std::out_of_range>([&list]() { list.insert(list.cbegin() + 30, 2, 0); });
+		}
+
+		TEST_METHOD(Erase) {
+			ChunkList<int, 8> list;
+			ChunkList<int, 8> list2;
+
+			for (int i = 1; i < 8; i++)
+				list2.push_back(i);
+
+
+			for (int i = 0; i < 8; i++)
+				list.push_back(i);
+
+			list.erase(list.cbegin());
+
+			Assert::IsTrue(list == list2);
+		}
+
+		template <class List>
+		static void check_erase_if(int keep_every) {
+			List list;
+			std::vector<int> expected;
+			for (int i = 0; i < 1000; i++) {
+				list.push_back(i);
+				expected.push_back(i);
+			}
+			auto pred = [keep_every](int v) { return v % keep_every != 0; };
+			Assert::IsTrue(erase_if(list, pred) == std::erase_if(expected, pred));
+			Assert::IsTrue(list.size() == expected.size());
+			Assert::IsTrue(std::ranges::equal(list, expected));
+			Assert::IsTrue(list.count_in_range(0, 499) == static_cast<std::size_t>(std::count_if(expected.begin(), expected.end(),
+				[](int v) { return v <= 499; })));
+			list.push_back(-1);
+			Assert::IsTrue(list.back() == -1);
+		}
+
+		TEST_METHOD(EraseIf) {
+			check_erase_if<ChunkList<int, 8>>(3);
+			check_erase_if<ChunkList<int, 8>>(1);
+			check_erase_if<ChunkList<int, 8>>(2000);
+			check_erase_if<SmallChunkList<int, 5, 8>>(7);
+			check_erase_if<ZoneMappedChunkList<int, 8>>(4);
+			check_erase_if<AggregatedChunkList<int, 16>>(5);
+
+			ChunkList<std::string, 4> words = { "a", "b", "a", "c", "a", "a", "d" };
+			Assert::IsTrue(erase(words, std::string("a")) == 4);
+			Assert::IsTrue(words == ChunkList<std::string, 4>({ "b", "c", "d" }));
+			Assert::IsTrue(erase(words, std::string("x")) == 0);
+			Assert::IsTrue(words.chunk_count() == 1);
+
+			ChunkList<std::string, 4> other = { "z" };
+			swap(words, other);
+			Assert::IsTrue(words.size() == 1 && other.size() == 3);
+		}
+
+		TEST_METHOD(PushAndPop) {
+			ChunkList<int, 8> list;
+
+			for (int i = 0; i < 8; i++)
+				list.push_back(i);
+
+			Assert::IsTrue(list[0] == 0);
+			Assert::IsTrue(list[7] == 7);
+
+			list.pop_back();
+			Assert::IsTrue(list.size() == 7);
+
+			list.push_front(350);
+			Assert::IsTrue(list[0] == 350);
+
+			list.pop_front();
+			Assert::IsTrue(list[0] == 0);
+		}
+
+		TEST_METHOD(Emplace) {
+			ChunkList<int, 8> list;
+
+			for (int i = 0; i < 8; i++)
+				list.push_back(i);
+
+			list.emplace_back(10);
+			list.emplace_front(22);
+
+			Assert::IsTrue(list[0] == 22);
+			Assert::IsTrue(list[9] == 10);
+		}
+	};
+
+	TEST_CLASS(RestructureTests) {
+		TEST_METHOD(Resize) {
+			ChunkList<int, 4> list;
+			auto list2 = list;
+
+			for (int i = 0; i < 4; i++)
+				list.push_back(i);
+
+			list.resize(3);
+
+			list2.push_back(0);
+			list2.push_back(1);
+			list2.push_back(2);
+
+			Assert::IsTrue(list == list2);
+		}
+
+		TEST_METHOD(ResizeGrow) {
+			ChunkList<int, 4> list;
+			list.resize(10, 7);
+
+			Assert::IsTrue(list.size() == 10);
+			Assert::IsTrue(list.chunk_count() == 3);
+			Assert::IsTrue(list[9] == 7);
+
+			list.resize(2);
+			Assert::IsTrue(list.size() == 2);
+			Assert::IsTrue(list.chunk_count() == 1);
+		}
+	};
+
+	TEST_CLASS(SpliceTests) {
+		template <class List>
+		static List make_list(int first, int count) {
+			List list;
+			for (int i = 0; i < count; i++)
+				list.push_back(first + i);
+			return list;
+		}
+
+		template <class List>
+		static void check_splicing() {
+			for (int left : { 0, 5, 8, 16, 21 }) {
+				for (int right : { 0, 3, 8, 24, 29 }) {
+					List list = make_list<List>(0, left);
+					list.append(make_list<List>(left, right));
+					Assert::IsTrue(std::ranges::equal(list, std::views::iota(0, left + right)));
+
+					for (int at : { 0, left / 2, left / 8 * 8, left }) {
+						List into = make_list<List>(0, left);
+						List other = make_list<List>(1000, right);
+						into.splice(into.cbegin() + at, other);
+						Assert::IsTrue(other.empty());
+						std::vector<int> expected(left + right);
+						std::iota(expected.begin(), expected.begin() + at, 0);
+						std::iota(expected.begin() + at, expected.begin() + at + right, 1000);
+						std::iota(expected.begin() + at + right, expected.end(), at);
+						Assert::IsTrue(std::ranges::equal(into, expected));
+
+						List tail = into.split_at(at);
+						Assert::IsTrue(into.size() == static_cast<std::size_t>(at));
+						Assert::IsTrue(std::ranges::equal(tail, expected | std::views::drop(at)));
+						into.push_back(-1);
+						tail.push_back(-2);
+						Assert::IsTrue(into.back() == -1 && tail.back() == -2);
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(AppendSpliceSplit) {
+			check_splicing<ChunkList<int, 8>>();
+			check_splicing<GeometricChunkList<int, 4, 16>>();
+			check_splicing<SmallChunkList<int, 3, 8>>();
+			check_splicing<ZoneMappedChunkList<int, 8>>();
+		}
+
+		TEST_METHOD(RelinksAlignedChunks) {
+			ChunkList<int, 8> merged;
+			std::vector<const int*> addresses;
+			for (int t = 0; t < 32; t++) {
+				ChunkList<int, 8> local = make_list<ChunkList<int, 8>>(t * 64, t == 31 ? 13 : 64);
+				addresses.push_back(&local[0]);
+				merged.append(std::move(local));
+				Assert::IsTrue(local.empty());
+			}
+			Assert::IsTrue(merged.size() == 31 * 64 + 13);
+			Assert::IsTrue(std::ranges::equal(merged, std::views::iota(0, 31 * 64 + 13)));
+			for (int t = 0; t < 32; t++)
+				Assert::IsTrue(&merged[t * 64] == addresses[t]);
+
+			ZoneMappedChunkList<int, 8> zoned = make_list<ZoneMappedChunkList<int, 8>>(0, 64);
+			ZoneMappedChunkList<int, 8> right = zoned.split_at(32);
+			const int* first_right = &right[0];
+			Assert::IsTrue(zoned.count_in_range(0, 100) == 32 && right.count_in_range(0, 100) == 32);
+			zoned.splice(zoned.cbegin() + 16, right);
+			Assert::IsTrue(&zoned[16] == first_right);
+			Assert::IsTrue(zoned.count_in_range(32, 47) == 16 && zoned.chunk_count() == 8);
+			Assert::ExpectException<std::out_of_range>([&zoned]() { zoned.split_at(65); });
+		}
+
+		template <class List>
+		static void check_merge(bool parallel) {
+			using Entry = typename List::value_type;
+			auto by_key = [](const Entry& a, const Entry& b) { return a.first < b.first; };
+			for (int left : { 0, 1, 8, 19, 64 }) {
+				for (int right : { 0, 5, 8, 40 }) {
+					// Keys repeat across both lists, the tag tells them apart
+					List into, other;
+					std::vector<Entry> expected;
+					for (int i = 0; i < left; i++)
+						into.push_back({ i * 3 / 2, 0 }), expected.push_back({ i * 3 / 2, 0 });
+					for (int i = 0; i < right; i++)
+						other.push_back({ i * 2, 1 }), expected.push_back({ i * 2, 1 });
+					std::ranges::stable_sort(expected, by_key);
+					if (parallel)
+						into.parallel_merge(std::move(other), by_key, 3);
+					else
+						into.merge(other, by_key);
+					Assert::IsTrue(other.empty());
+					Assert::IsTrue(std::ranges::equal(into, expected));
+					into.push_back({ 1000, 2 });
+					Assert::IsTrue(into.back().first == 1000 && into.size() == expected.size() + 1);
+				}
+			}
+		}
+
+		TEST_METHOD(MergeSorted) {
+			check_merge<ChunkList<std::pair<int, int>, 8>>(false);
+			check_merge<GeometricChunkList<std::pair<int, int>, 4, 16>>(false);
+			check_merge<SmallChunkList<std::pair<int, int>, 3, 8>>(false);
+			check_merge<ChunkList<std::pair<int, int>, 8>>(true);
+			check_merge<SmallChunkList<std::pair<int, int>, 3, 8>>(true);
+
+			ZoneMappedChunkList<int, 8> odd, even;
+			for (int i = 0; i < 100; i++)
+				(i % 2 ? odd : even).push_back(i);
+			odd.merge(std::move(even));
+			Assert::IsTrue(std::ranges::equal(odd, std::views::iota(0, 100)));
+			Assert::IsTrue(odd.chunk_count() == 13 && odd.count_in_range(10, 19) == 10);
+		}
+
+		TEST_METHOD(ParallelMergeLargeInputs) {
+			ChunkList<int, 64> left, right;
+			for (int i = 0; i < 50000; i++)
+				left.push_back(i * 2);
+			for (int i = 0; i < 30000; i++)
+				right.push_back(i * 3);
+			std::vector<int> expected(left.begin(), left.end());
+			expected.insert(expected.end(), right.begin(), right.end());
+			std::ranges::stable_sort(expected);
+			left.parallel_merge(std::move(right), std::less<>(), 4);
+			Assert::IsTrue(right.empty());
+			Assert::IsTrue(std::ranges::equal(left, expected));
+		}
+
+		TEST_METHOD(ParallelMergeMovesStrings) {
+			// Strings too long for the small buffer are left empty once moved
+			// from, so reading an input another range has consumed shows up
+			auto key = [](int i) { return "element " + std::string(32, 'x') + std::to_string(100000 + i); };
+			ChunkList<std::string, 64> left, right;
+			for (int i = 0; i < 20000; i++) {
+				left.push_back(key(i * 2));
+				right.push_back(key(i * 2 + 1));
+			}
+			std::vector<std::string> expected;
+			for (int i = 0; i < 40000; i++)
+				expected.push_back(key(i));
+			left.parallel_merge(std::move(right), std::less<>(), 8);
+			Assert::IsTrue(std::ranges::equal(left, expected));
+		}
+	};
+
+	TEST_CLASS(ChunkSizePolicyTests) {
+		TEST_METHOD(RuntimePolicy) {
+			RuntimeChunkList<int, 8> list(RuntimeChunkSize<8>(3));
+			for (int i = 0; i < 10; i++)
+				list.push_back(i);
+
+			Assert::IsTrue(list.chunk_count() == 4);
+			Assert::IsTrue(list.max_size() == 12);
+			for (int i = 0; i < 10; i++)
+				Assert::IsTrue(list.at(i) == i);
+			Assert::ExpectException<std::invalid_argument>([]() {
+				RuntimeChunkSize<8> policy(0);
+				});
+		}
+
+		TEST_METHOD(GeometricPolicy) {
+			GeometricChunkList<int, 4, 16> list;
+			for (int i = 0; i < 100; i++)
+				list.push_back(i);
+
+			// 4 + 8 + 16 * 6 chunks
+			Assert::IsTrue(list.chunk_count() == 8);
+			Assert::IsTrue(list.max_size() == 108);
+			for (int i = 0; i < 100; i++)
+				Assert::IsTrue(list[i] == i);
+
+			list.insert(list.cbegin() + 5, 500);
+			list.erase(list.cbegin());
+			Assert::IsTrue(list[4] == 500);
+			Assert::IsTrue(list[5] == 5);
+			Assert::IsTrue(list.back() == 99);
+		}
+
+		TEST_METHOD(DefaultChunkSize) {
+			static_assert(default_chunk_size<int>() == 1024);
+			static_assert(default_chunk_size<char[24]>() == 128);
+			static_assert(default_chunk_size<char[8192]>() == 1);
+			static_assert(default_chunk_size<double, cache_line_size * 4>() == 32);
+
+			ChunkList<int> list;
+			for (int i = 0; i < 3000; i++)
+				list.push_back(i);
+			Assert::IsTrue(list.chunk_count() == 3);
+			Assert::IsTrue(list.max_size() == 3072);
+			Assert::IsTrue(list[2047] == 2047);
+			Assert::IsTrue(list[2048] == 2048);
+		}
+
+		TEST_METHOD(EmptyListHasNoChunks) {
+			ChunkList<int, 8> list;
+			Assert::IsTrue(list.chunk_count() == 0);
+			Assert::IsTrue(list.last_chunk() == nullptr);
+		}
+
+		TEST_METHOD(InlineFirstChunk) {
+			SmallChunkList<int, 4, 8> list;
+			for (int i = 0; i < 4; i++)
+				list.push_back(i);
+
+			// The first chunk lives inside the list object
+			auto object = reinterpret_cast<const char*>(&list);
+			auto chunk = reinterpret_cast<const char*>(list.last_chunk());
+			Assert::IsTrue(chunk >= object && chunk < object + sizeof(list));
+			Assert::IsTrue(list.max_size() == 4);
+
+			for (int i = 4; i < 30; i++)
+				list.push_back(i);
+			Assert::IsTrue(list.chunk_count() == 5);
+			Assert::IsTrue(list.max_size() == 36);
+			for (int i = 0; i < 30; i++)
+				Assert::IsTrue(list[i] == i);
+
+			list.insert(list.cbegin() + 2, 100);
+			list.erase(list.cbegin() + 10);
+			Assert::IsTrue(list[2] == 100);
+			Assert::IsTrue(list[10] == 10);
+			list.resize(3);
+			Assert::IsTrue(list.chunk_count() == 1);
+		}
+
+		TEST_METHOD(InlineFirstChunkMoveAndSwap) {
+			SmallChunkList<int, 4, 8> list = { 1, 2, 3, 4, 5, 6 };
+			SmallChunkList<int, 4, 8> small = { 7, 8 };
+
+			SmallChunkList<int, 4, 8> moved(std::move(list));
+			Assert::IsTrue(list.empty());
+			Assert::IsTrue(moved.size() == 6);
+			Assert::IsTrue(moved[5] == 6);
+
+			moved.swap(small);
+			Assert::IsTrue(moved == SmallChunkList<int, 4, 8>({ 7, 8 }));
+			Assert::IsTrue(small == SmallChunkList<int, 4, 8>({ 1, 2, 3, 4, 5, 6 }));
+			small.push_back(7);
+			small.pop_front();
+			Assert::IsTrue(small.front() == 2);
+			Assert::IsTrue(small.back() == 7);
+
+			list = small;
+			Assert::IsTrue(list == small);
+		}
+
+		TEST_METHOD(NonPowerOfTwoChunkSize) {
+			ChunkList<int, 5> list;
+			for (int i = 0; i < 23; i++)
+				list.push_back(i);
+			Assert::IsTrue(list.chunk_count() == 5);
+			for (int i = 0; i < 23; i++)
+				Assert::IsTrue(list.at(i) == i);
+		}
+	};
+
+	TEST_CLASS(SwapTests) {
+		TEST_METHOD(Swap) {
+			ChunkList<int, 4> list;
+			auto list2 = list;
+			auto list3 = list;
+
+			for (int i = 0; i < 4; i++) {
+				list.push_back(1);
+				list2.push_back(2);
+				list3.push_back(2);
+			}
+
+			Assert::IsTrue(list != list2);
+			Assert::IsTrue(list2 == list3);
+
+			list.swap(list2);
+
+			Assert::IsTrue(list == list3);
+			Assert::IsTrue(list2 != list3);
+		}
+	};
+
+	/// @brief Integer counting the comparisons made on it, to see which chunks a
+	/// query reads.
+	struct Counted {
+		int value = 0;
+		static inline std::size_t comparisons = 0;
+
+		friend bool operator<(const Counted& lhs, const Counted& rhs) {
+			comparisons++;
+			return lhs.value < rhs.value;
+		}
+	};
+
+	TEST_CLASS(ZoneMapTests) {
+		template <class List>
+		static void check_queries(const List& list, const std::vector<int>& expected, int lo, int hi) {
+			std::size_t count = std::count_if(expected.begin(), expected.end(),
+				[lo, hi](int value) { return lo <= value && value <= hi; });
+			Assert::IsTrue(list.count_in_range(lo, hi) == count);
+			std::vector<int> filtered;
+			list.filter_range(lo, hi, [&filtered](int value) { filtered.push_back(value); });
+			Assert::IsTrue(filtered.size() == count);
+			auto it = std::find_if(expected.begin(), expected.end(),
+				[lo, hi](int value) { return lo <= value && value <= hi; });
+			Assert::IsTrue(list.find_in_range(lo, hi) == static_cast<std::size_t>(it - expected.begin()));
+			auto found = std::find(expected.begin(), expected.end(), lo);
+			Assert::IsTrue(list.find_value(lo) == static_cast<std::size_t>(found - expected.begin()));
+		}
+
+		template <class List>
+		static void check_modifiers() {
+			List list;
+			std::vector<int> expected;
+			std::mt19937 rng(7);
+			for (int i = 0; i < 4000; i++) {
+				int value = static_cast<int>(rng() % 1000);
+				switch (rng() % 8) {
+				case 0:
+					if (!expected.empty()) {
+						std::size_t pos = rng() % expected.size();
+						list.insert(list.cbegin() + pos, value);
+						expected.insert(expected.begin() + pos, value);
+					}
+					break;
+				case 1:
+					if (!expected.empty()) {
+						std::size_t pos = rng() % expected.size();
+						list.erase(list.cbegin() + pos);
+						expected.erase(expected.begin() + pos);
+					}
+					break;
+				case 2:
+					list.pop_back();
+					if (!expected.empty())
+						expected.pop_back();
+					break;
+				case 3:
+					if (!expected.empty()) {
+						std::size_t pos = rng() % expected.size();
+						list[pos] = value;
+						expected[pos] = value;
+					}
+					break;
+				case 4:
+					if (i % 4 == 0 && !expected.empty()) {
+						std::size_t first = rng() % expected.size();
+						std::size_t last = std::min(expected.size(), first + rng() % 20);
+						auto it = list.erase(list.cbegin() + first, list.cbegin() + last);
+						expected.erase(expected.begin() + first, expected.begin() + last);
+						Assert::IsTrue(it == list.begin() + first);
+						break;
+					}
+					[[fallthrough]];
+				default:
+					list.push_back(value);
+					expected.push_back(value);
+				}
+				if (i % 97 == 0) {
+					int lo = static_cast<int>(rng() % 1000);
+					check_queries(list, expected, lo, lo + static_cast<int>(rng() % 50));
+				}
+			}
+			Assert::IsTrue(std::ranges::equal(std::as_const(list), expected));
+			list.resize(list.size() / 2);
+			expected.resize(expected.size() / 2);
+			for (int lo = 0; lo < 1000; lo += 37)
+				check_queries(list, expected, lo, lo + 20);
+			list.clear();
+			expected.clear();
+			check_queries(list, expected, 0, 1000);
+		}
+
+		TEST_METHOD(MatchesScanAfterModifiers) {
+			check_modifiers<ZoneMappedChunkList<int, 8>>();
+			check_modifiers<ZoneMappedChunkList<int, 8, 128>>();
+			check_modifiers<ChunkList<int, 8, Allocator<int>, FixedChunkSize<8>, 5, ZoneMap<int>>>();
+			check_modifiers<ChunkList<int, 8>>();
+		}
+
+		TEST_METHOD(SkipsChunksOutsideRange) {
+			ZoneMappedChunkList<Counted, 64> list;
+			for (int i = 0; i < 6400; i++)
+				list.push_back(Counted{ i });
+			Counted::comparisons = 0;
+			Assert::IsTrue(list.count_in_range(Counted{ 1000 }, Counted{ 1999 }) == 1000);
+			// Two boundary chunks are read, the others are decided by their bounds
+			Assert::IsTrue(Counted::comparisons < 2 * 64 * 2 + 100 * 4);
+
+			// Writes through a reference make the chunk summary stale
+			list[5000].value = -1;
+			Assert::IsTrue(list.count_in_range(Counted{ -1 }, Counted{ -1 }) == 1);
+			Assert::IsTrue(list.find_in_range(Counted{ -5 }, Counted{ 0 }) == 0);
+			Assert::IsTrue(list.find_in_range(Counted{ -5 }, Counted{ -1 }, 1) == 5000);
+			Assert::IsTrue(list.find_in_range(Counted{ 7000 }, Counted{ 8000 }) == list.size());
+		}
+
+		TEST_METHOD(BloomFilterSkipsMissingValues) {
+			ZoneMappedChunkList<int, 64, 512> list;
+			std::mt19937 rng(3);
+			std::vector<int> expected;
+			for (int i = 0; i < 6400; i++) {
+				int value = static_cast<int>(rng() % 100000) * 2;
+				list.push_back(value);
+				expected.push_back(value);
+			}
+			for (int i = 0; i < 200; i++) {
+				int value = static_cast<int>(rng() % 200000);
+				auto it = std::find(expected.begin(), expected.end(), value);
+				Assert::IsTrue(list.find_value(value) == static_cast<std::size_t>(it - expected.begin()));
+			}
+			Assert::IsTrue(list.find_value(expected[4321], 4321) == 4321);
+		}
+	};
+
+	TEST_CLASS(ChunkAggregatesTests) {
+		template <class List>
+		static void check_ranges(const List& list, const std::vector<long long>& expected, std::mt19937& rng) {
+			for (int q = 0; q < 20; q++) {
+				std::size_t first = rng() % (expected.size() + 1);
+				std::size_t last = first + rng() % (expected.size() - first + 1);
+				long long sum = 0;
+				for (std::size_t i = first; i < last; i++)
+					sum += expected[i];
+				Assert::IsTrue(list.range_sum(first, last) == sum);
+				if (first == last)
+					continue;
+				Assert::IsTrue(list.range_min(first, last) == *std::min_element(expected.begin() + first, expected.begin() + last));
+				Assert::IsTrue(list.range_max(first, last) == *std::max_element(expected.begin() + first, expected.begin() + last));
+			}
+		}
+
+		template <class List>
+		static void check_modifiers() {
+			List list;
+			std::vector<long long> expected;
+			std::mt19937 rng(5);
+			for (int i = 0; i < 3000; i++) {
+				long long value = static_cast<long long>(rng() % 2000) - 1000;
+				std::size_t pos = expected.empty() ? 0 : rng() % expected.size();
+				switch (rng() % 6) {
+				case 0:
+					if (!expected.empty()) {
+						list.insert(list.cbegin() + pos, value);
+						expected.insert(expected.begin() + pos, value);
+					}
+					break;
+				case 1:
+					if (!expected.empty()) {
+						list.erase(list.cbegin() + pos);
+						expected.erase(expected.begin() + pos);
+					}
+					break;
+				case 2:
+					if (!expected.empty()) {
+						list.at(pos) = value;
+						expected[pos] = value;
+					}
+					break;
+				default:
+					list.push_back(value);
+					expected.push_back(value);
+				}
+				if (i % 50 == 0)
+					check_ranges(list, expected, rng);
+			}
+			list.resize(expected.size() / 3);
+			expected.resize(expected.size() / 3);
+			check_ranges(list, expected, rng);
+		}
+
+		TEST_METHOD(MatchesScanAfterModifiers) {
+			check_modifiers<AggregatedChunkList<long long, 16>>();
+			check_modifiers<ChunkList<long long, 16>>();
+		}
+
+		TEST_METHOD(RangeChecks) {
+			AggregatedChunkList<int, 4> list = { 5, 1, 9, 3, 7, 2, 8 };
+			Assert::IsTrue(list.range_sum(0, 7) == 35);
+			Assert::IsTrue(list.range_sum(2, 2) == 0);
+			Assert::IsTrue(list.range_min(1, 6) == 1);
+			Assert::IsTrue(list.range_max(3, 7) == 8);
+			Assert::IsTrue(list.count_in_range(3, 7) == 3);
+			Assert::ExpectException<std::out_of_range>([&list]() { list.range_sum(3, 8); });
+			Assert::ExpectException<std::out_of_range>([&list]() { list.range_min(4, 4); });
+			list.pop_back();
+			list.pop_back();
+			Assert::IsTrue(list.range_max(0, 5) == 9);
+			list[2] = 0;
+			Assert::IsTrue(list.range_max(0, 5) == 7);
+			Assert::IsTrue(list.range_min(0, 4) == 0);
+		}
+	};
+
+	TEST_CLASS(DeltaTests) {
+		using List = TrackedChunkList<int, 8>;
+
+		static std::size_t sync(DeltaTracker<List>& tracker, List& primary, List& replica) {
+			ChunkListDelta<int> delta = tracker.delta(primary);
+			apply_delta(replica, delta);
+			Assert::IsTrue(replica == primary);
+			return delta.chunks.size();
+		}
+
+		TEST_METHOD(SendsChangedChunks) {
+			List primary, replica;
+			DeltaTracker<List> tracker;
+			for (int i = 0; i < 100; i++)
+				primary.push_back(i);
+			Assert::IsTrue(sync(tracker, primary, replica) == 13);
+			Assert::IsTrue(sync(tracker, primary, replica) == 0);
+
+			primary[42] = -1;
+			Assert::IsTrue(sync(tracker, primary, replica) == 1);
+			primary.push_back(100);
+			primary.push_back(101);
+			Assert::IsTrue(sync(tracker, primary, replica) == 1);
+			primary.resize(60);
+			Assert::IsTrue(sync(tracker, primary, replica) == 1);
+			std::reverse(&primary[8], &primary[8] + 8);
+			Assert::IsTrue(sync(tracker, primary, replica) == 1);
+			primary.erase(primary.cbegin() + 50);
+			Assert::IsTrue(sync(tracker, primary, replica) == 2);
+			primary.clear();
+			Assert::IsTrue(sync(tracker, primary, replica) == 0 && replica.empty());
+		}
+
+		TEST_METHOD(ConstReadsSendNothing) {
+			List primary, replica;
+			DeltaTracker<List> tracker;
+			for (int i = 0; i < 1000; i++)
+				primary.push_back(i);
+			Assert::IsTrue(sync(tracker, primary, replica) == 125);
+
+			long long sum = 0;
+			for (int v : std::as_const(primary))
+				sum += v;
+			for (auto it = primary.cbegin(); it != primary.cend(); ++it)
+				sum += *it;
+			for_each_segmented(std::as_const(primary), [&sum](int v) { sum += v; });
+			sum += std::as_const(primary)[500] + std::as_const(primary).at(999);
+			Assert::IsTrue(sum == 3 * 499500ll + 500 + 999);
+			Assert::IsTrue(sync(tracker, primary, replica) == 0);
+
+			// A non-const read may have written through its reference
+			sum += primary[500];
+			Assert::IsTrue(sync(tracker, primary, replica) == 1);
+		}
+
+		TEST_METHOD(FollowsRelinkedChunks) {
+			List primary, replica;
+			DeltaTracker<List> tracker;
+			for (int i = 0; i < 64; i++)
+				primary.push_back(i);
+			sync(tracker, primary, replica);
+
+			List tail = primary.split_at(32);
+			List inserted;
+			for (int i = 0; i < 16; i++)
+				inserted.push_back(1000 + i);
+			primary.append(std::move(inserted));
+			primary.append(std::move(tail));
+			Assert::IsTrue(primary.size() == 80 && std::as_const(primary)[32] == 1000 && std::as_const(primary)[48] == 32);
+			Assert::IsTrue(sync(tracker, primary, replica) == 2);
+
+			std::swap(primary[0], primary[79]);
+			Assert::IsTrue(sync(tracker, primary, replica) == 2);
+		}
+
+		TEST_METHOD(RejectsForeignDelta) {
+			List primary, replica, other;
+			DeltaTracker<List> tracker, other_tracker;
+			for (int i = 0; i < 20; i++) {
+				primary.push_back(i);
+				other.push_back(i);
+			}
+			sync(tracker, primary, replica);
+			other_tracker.delta(other);
+			ChunkListDelta<int> delta = other_tracker.delta(other);
+			Assert::ExpectException<std::invalid_argument>([&]() { apply_delta(replica, delta); });
+		}
+	};
+
+	/// @brief Hash of int counting its calls, to see which chunks are rehashed.
+	struct CountingHash {
+		static inline std::size_t calls = 0;
+
+		std::size_t operator()(int value) const {
+			calls++;
+			return std::hash<int>()(value);
+		}
+	};
+
+	TEST_CLASS(FingerprintTests) {
+		TEST_METHOD(RehashesWrittenChunks) {
+			FingerprintedChunkList<int, 8, CountingHash> list, copy;
+			for (int i = 0; i < 80; i++) {
+				list.push_back(i);
+				copy.push_back(i);
+			}
+			CountingHash::calls = 0;
+			std::uint64_t original = fingerprint(list);
+			Assert::IsTrue(CountingHash::calls == 80 && original == fingerprint(copy));
+			CountingHash::calls = 0;
+			Assert::IsTrue(fingerprint(list) == original && CountingHash::calls == 0);
+
+			list[37] = -1;
+			Assert::IsTrue(fingerprint(list) != original && CountingHash::calls == 8);
+			list[37] = 37;
+			Assert::IsTrue(fingerprint(list) == original);
+			list.push_back(80);
+			Assert::IsTrue(fingerprint(list) != original);
+			list.pop_back();
+			Assert::IsTrue(fingerprint(list) == original);
+
+			FingerprintedChunkList<int, 8> shifted, direct;
+			for (int i = 0; i < 79; i++)
+				shifted.push_back(i + 1);
+			Assert::IsTrue(fingerprint(shifted) != fingerprint(direct));
+			shifted.push_front(0);
+			for (int i = 0; i < 80; i++)
+				direct.push_back(i);
+			Assert::IsTrue(fingerprint(shifted) == fingerprint(direct));
+		}
+
+		TEST_METHOD(DedupStoresSharedChunksOnce) {
+			using List = FingerprintedChunkList<std::string, 4>;
+			ChunkDedupStore<List> store;
+			List list;
+			for (int i = 0; i < 40; i++)
+				list.push_back(std::to_string(i % 8));
+			auto first = store.snapshot(list);
+			Assert::IsTrue(first.size() == 10 && store.payload_count() == 2);
+
+			list[5] = "x";
+			auto second = store.snapshot(list);
+			Assert::IsTrue(store.payload_count() == 3);
+			Assert::IsTrue(ChunkDedupStore<List>::restore(first) != list);
+			Assert::IsTrue(ChunkDedupStore<List>::restore(second) == list);
+
+			first.clear();
+			store.collect();
+			Assert::IsTrue(store.payload_count() == 3);
+			second.clear();
+			store.collect();
+			Assert::IsTrue(store.payload_count() == 0);
+		}
+	};
+
+	TEST_CLASS(StatsTests) {
+		TEST_METHOD(LayoutAndCounters) {
+			ChunkList<int, 8> list;
+			for (int i = 0; i < 20; i++)
+				list.push_back(i);
+			ChunkListStats stats = list.stats();
+			Assert::IsTrue(stats.chunks == 3 && stats.elements == 20 && stats.capacity == 24);
+			Assert::IsTrue(stats.slack_bytes == 4 * sizeof(int) && stats.fill_factor == 20.0 / 24.0);
+			Assert::IsTrue(stats.occupancy[9] == 2 && stats.occupancy[5] == 1);
+
+			list.insert(list.cbegin() + 2, -1);
+			list.erase(list.cbegin() + 18);
+			std::as_const(list)[17];
+			for (int i = 0; i < 9; i++)
+				list.pop_back();
+			stats = list.stats();
+			Assert::IsTrue(stats.chunks == 2 && stats.elements == 11);
+			if constexpr (stats_enabled) {
+				Assert::IsTrue(stats.chunks_allocated == 3 && stats.chunks_freed == 1);
+				Assert::IsTrue(stats.elements_moved == 18 + 2);
+				Assert::IsTrue(stats.lookup_hops >= 4);
+				list.reset_stats();
+				Assert::IsTrue(list.stats().chunks_allocated == 0);
+			}
+			else {
+				Assert::IsTrue(stats.chunks_allocated == 0 && stats.lookup_hops == 0);
+			}
+
+			ChunkList<int, 8> empty;
+			Assert::IsTrue(empty.stats().fill_factor == 1.0 && empty.stats().chunks == 0);
+		}
+	};
+
+	TEST_CLASS(SortedChunkListTests) {
+		TEST_METHOD(MatchesMultiset) {
+			SortedChunkList<int, 8> list;
+			std::multiset<int> expected;
+			std::mt19937 rng(1);
+			for (int i = 0; i < 3000; i++) {
+				int key = static_cast<int>(rng() % 500);
+				if (rng() % 4 == 0) {
+					Assert::IsTrue(list.erase_key(key) == expected.erase(key));
+				}
+				else {
+					Assert::IsTrue(*list.insert_sorted(key) == key);
+					expected.insert(key);
+				}
+			}
+			Assert::IsTrue(list.size() == expected.size());
+			Assert::IsTrue(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+			Assert::IsTrue(list.chunk_count() * 2 <= list.size());
+
+			for (int key = -1; key <= 501; key++) {
+				auto it = list.lower_bound(key);
+				auto ex = expected.lower_bound(key);
+				Assert::IsTrue((it == list.end()) == (ex == expected.end()));
+				if (ex != expected.end())
+					Assert::IsTrue(*it == *ex);
+				Assert::IsTrue(list.count(key) == expected.count(key));
+				Assert::IsTrue(list.contains(key) == expected.contains(key));
+				auto [first, last] = list.equal_range(key);
+				Assert::IsTrue(static_cast<std::size_t>(std::distance(first, last)) == expected.count(key));
+			}
+			Assert::IsTrue(list.at(0) == *expected.begin());
+			Assert::IsTrue(list.back() == *expected.rbegin());
+			Assert::IsTrue(*std::prev(list.end()) == *expected.rbegin());
+		}
+
+		TEST_METHOD(BulkLoadAndDrain) {
+			std::vector<int> keys;
+			for (int i = 0; i < 1000; i++)
+				keys.push_back(i / 3);
+			SortedChunkList<int, 16> list;
+			list.assign_sorted(keys.begin(), keys.end());
+			Assert::IsTrue(list.size() == 1000);
+			Assert::IsTrue(list.chunk_count() == 84);
+			Assert::IsTrue(list.count(100) == 3);
+			Assert::IsTrue(*list.upper_bound(100) == 101);
+			Assert::IsTrue(list.upper_bound(333) == list.end());
+
+			for (int key = 0; key < 334; key++)
+				list.erase_key(key);
+			Assert::IsTrue(list.empty());
+			Assert::IsTrue(list.chunk_count() == 0);
+			Assert::ExpectException<std::invalid_argument>([&list]() {
+				std::vector<int> unsorted = { 3, 1, 2 };
+				list.assign_sorted(unsorted.begin(), unsorted.end());
+				});
+		}
+
+		TEST_METHOD(EraseKeepsChunksDense) {
+			// A run of 5 starting in the first chunk and ending in the third
+			std::vector<int> keys = { 0, 0 };
+			keys.insert(keys.end(), 30, 5);
+			for (int i = 6; i < 30; i++)
+				keys.push_back(i);
+			SortedChunkList<int, 16> list;
+			list.assign_sorted(keys.begin(), keys.end());
+			Assert::IsTrue(list.chunk_count() == 5);
+
+			Assert::IsTrue(list.erase_key(5) == 30);
+			Assert::IsTrue(list.size() == 26);
+			Assert::IsTrue(list.chunk_count() == 3);
+			std::erase(keys, 5);
+			Assert::IsTrue(std::ranges::equal(list, keys));
+		}
+
+		TEST_METHOD(CustomOrder) {
+			SortedChunkList<int, 4, std::greater<int>> list = { 1, 5, 3, 9, 7, 5 };
+			std::vector<int> ordered(list.begin(), list.end());
+			Assert::IsTrue(ordered == std::vector<int>{ 9, 7, 5, 5, 3, 1 });
+			Assert::IsTrue(*list.lower_bound(6) == 5);
+			SortedChunkList<int, 4, std::greater<int>> copy = list;
+			Assert::IsTrue(copy.erase_key(5) == 2);
+			Assert::IsTrue(list.size() == 6);
+			Assert::IsTrue(copy.size() == 4);
+		}
+	};
+
+	TEST_CLASS(BoolChunkListTests) {
+		TEST_METHOD(PackedFlags) {
+			ChunkList<bool, 100> flags;
+			std::vector<bool> expected;
+			for (int i = 0; i < 1000; i++) {
+				bool value = i % 3 == 0 || i % 7 == 0;
+				flags.push_back(value);
+				expected.push_back(value);
+			}
+			Assert::IsTrue(flags.size() == 1000);
+			Assert::IsTrue(flags.chunk_count() == 10);
+			for (int i = 0; i < 1000; i++)
+				Assert::IsTrue(flags[i] == expected[i]);
+			Assert::IsTrue(flags.count() == static_cast<std::size_t>(std::count(expected.begin(), expected.end(), true)));
+
+			flags[1] = true;
+			flags.at(0) = false;
+			flags[2] = flags[1];
+			Assert::IsTrue(flags[1] && flags[2] && !flags[0]);
+			flags.back().flip();
+			Assert::IsTrue(flags.back() != expected.back());
+			Assert::ExpectException<std::out_of_range>([&flags]() { flags.at(1000); });
+		}
+
+		TEST_METHOD(FindSetFlags) {
+			ChunkList<bool, 100> flags(1000);
+			Assert::IsTrue(flags.count() == 0);
+			Assert::IsTrue(flags.find_first() == flags.npos);
+			flags[5] = true;
+			flags[64] = true;
+			flags[99] = true;
+			flags[100] = true;
+			flags[999] = true;
+
+			std::vector<std::size_t> found;
+			for (std::size_t pos = flags.find_first(); pos != flags.npos; pos = flags.find_next(pos))
+				found.push_back(pos);
+			Assert::IsTrue(found == std::vector<std::size_t>{ 5, 64, 99, 100, 999 });
+
+			flags.flip();
+			Assert::IsTrue(flags.count() == 995);
+			flags.resize(990);
+			Assert::IsTrue(flags.count() == 986);
+			flags.resize(1000);
+			Assert::IsTrue(flags.count() == 986);
+			Assert::IsTrue(flags.find_next(989) == flags.npos);
+			flags.resize(1010, true);
+			Assert::IsTrue(flags.count() == 996);
+			flags.pop_back();
+			Assert::IsTrue(flags.size() == 1009);
+		}
+
+		TEST_METHOD(BulkOperations) {
+			ChunkList<bool, 128> a(300), b(300);
+			for (std::size_t i = 0; i < 300; i += 2)
+				a[i] = true;
+			for (std::size_t i = 0; i < 300; i += 3)
+				b[i] = true;
+			Assert::IsTrue((a & b).count() == 50);
+			Assert::IsTrue((a | b).count() == 200);
+			Assert::IsTrue((a ^ b).count() == 150);
+
+			ChunkList<bool, 128> c = a;
+			c ^= a;
+			Assert::IsTrue(c.count() == 0);
+			Assert::IsTrue(c == ChunkList<bool, 128>(300));
+			Assert::IsTrue(!(c == a));
+			ChunkList<bool, 128> shorter(10);
+			Assert::ExpectException<std::invalid_argument>([&a, &shorter]() { a &= shorter; });
+		}
+
+		static_assert(std::random_access_iterator<ChunkList<bool, 100>::iterator>);
+		static_assert(std::random_access_iterator<ChunkList<bool, 100>::const_iterator>);
+
+		TEST_METHOD(IteratorsInsertErase) {
+			ChunkList<bool, 100> flags;
+			std::vector<bool> expected;
+			for (int i = 0; i < 450; i++) {
+				flags.push_back(i % 5 == 0);
+				expected.push_back(i % 5 == 0);
+			}
+			Assert::IsTrue(std::ranges::equal(flags, expected));
+			std::size_t set = 0;
+			for (bool flag : std::as_const(flags))
+				set += flag;
+			Assert::IsTrue(set == flags.count());
+			for (auto flag : flags)
+				flag = !flag;
+			Assert::IsTrue(flags.count() == 450 - set);
+			std::ranges::reverse(flags);
+			std::ranges::reverse(flags);
+			for (auto flag : flags)
+				flag.flip();
+			Assert::IsTrue(std::ranges::equal(flags | std::views::reverse, expected | std::views::reverse));
+
+			std::mt19937 rng(5);
+			for (int i = 0; i < 300; i++) {
+				std::size_t pos = rng() % (expected.size() + 1);
+				bool value = rng() % 2 == 0;
+				auto it = flags.insert(flags.cbegin() + static_cast<std::ptrdiff_t>(pos), value);
+				expected.insert(expected.begin() + static_cast<std::ptrdiff_t>(pos), value);
+				Assert::IsTrue(*it == value && it - flags.begin() == static_cast<std::ptrdiff_t>(pos));
+				pos = rng() % expected.size();
+				flags.erase(flags.cbegin() + static_cast<std::ptrdiff_t>(pos));
+				expected.erase(expected.begin() + static_cast<std::ptrdiff_t>(pos));
+				if (i % 2 == 0) {
+					flags.erase(flags.cbegin());
+					expected.erase(expected.begin());
+				}
+			}
+			Assert::IsTrue(std::ranges::equal(flags, expected));
+			Assert::IsTrue(flags.count() == static_cast<std::size_t>(std::ranges::count(expected, true)));
+			Assert::IsTrue(flags.find_next(flags.size() - 1) == flags.npos);
+
+			ChunkList<bool, 100> copy = flags;
+			Assert::IsTrue(std::hash<ChunkList<bool, 100>>()(copy) == std::hash<ChunkList<bool, 100>>()(flags));
+			copy.back().flip();
+			Assert::IsTrue(std::hash<ChunkList<bool, 100>>()(copy) != std::hash<ChunkList<bool, 100>>()(flags));
+		}
+	};
+
+	struct Tick {
+		std::int64_t timestamp;
+		int id;
+		double value;
+		char unused;
+	};
+
+	using TickList = ColumnChunkList<Tick, 16, &Tick::timestamp, &Tick::id, &Tick::value>;
+
+	TEST_CLASS(ColumnChunkListTests) {
+		TEST_METHOD(PositionalAccess) {
+			TickList list;
+			for (int i = 0; i < 100; i++)
+				list.push_back({ 1000 + i, i, i * 0.5, 'x' });
+			Assert::IsTrue(list.size() == 100);
+			Assert::IsTrue(list.chunk_count() == 7);
+
+			Tick tick = list.at(42);
+			Assert::IsTrue(tick.timestamp == 1042 && tick.id == 42 && tick.value == 21.0);
+			Assert::IsTrue(tick.unused == 0);
+
+			list[42] = Tick{ 1, 2, 3.0, 'y' };
+			Assert::IsTrue(static_cast<Tick>(list[42]).id == 2);
+			list[43].get<&Tick::value>() = -1.0;
+			Assert::IsTrue(list.get<&Tick::value>(43) == -1.0);
+			list[0] = list[99];
+			Assert::IsTrue(list.get<&Tick::timestamp>(0) == 1099);
+
+			const TickList& view = list;
+			Assert::IsTrue(view.back().id == 99);
+			Assert::ExpectException<std::out_of_range>([&view]() { view.at(100); });
+
+			for (int i = 0; i < 90; i++)
+				list.pop_back();
+			Assert::IsTrue(list.size() == 10);
+			Assert::IsTrue(list.chunk_count() == 1);
+			TickList copy = list;
+			Assert::IsTrue(std::as_const(copy).back().timestamp == 1009);
+		}
+
+		TEST_METHOD(ColumnSpans) {
+			TickList list;
+			for (int i = 0; i < 40; i++)
+				list.push_back({ i, i % 3, 1.0, 0 });
+			std::span<const double> values = std::as_const(list).column<&Tick::value>(2);
+			Assert::IsTrue(values.size() == 8);
+
+			double total = 0;
+			std::int64_t stamps = 0;
+			list.for_each_column<&Tick::value>([&total](std::span<const double> column) {
+				for (double v : column)
+					total += v;
+				});
+			list.for_each_column<&Tick::timestamp>([&stamps](std::span<const std::int64_t> column) {
+				for (std::int64_t v : column)
+					stamps += v;
+				});
+			Assert::IsTrue(total == 40.0);
+			Assert::IsTrue(stamps == 40 * 39 / 2);
+
+			for (int& id : list.column<&Tick::id>(0))
+				id = 7;
+			Assert::IsTrue(static_cast<Tick>(list.front()).id == 7);
+			Assert::IsTrue(list[16].get<&Tick::id>() == 1);
+		}
+
+		TEST_METHOD(MovedFromIsEmpty) {
+			TickList list;
+			for (int i = 0; i < 20; i++)
+				list.push_back({ i, i, 0.0, 0 });
+			TickList moved(std::move(list));
+			Assert::IsTrue(moved.size() == 20 && moved.get<&Tick::id>(19) == 19);
+			Assert::IsTrue(list.empty() && list.chunk_count() == 0);
+			Assert::ExpectException<std::out_of_range>([&list]() { list.at(0); });
+			list.pop_back();
+			list.push_back({ 5, 6, 7.0, 0 });
+			Assert::IsTrue(list.size() == 1 && static_cast<Tick>(list.at(0)).id == 6);
+
+			list = std::move(moved);
+			Assert::IsTrue(list.size() == 20);
+		}
+	};
+
+	TEST_CLASS(CompressedChunkListTests) {
+		TEST_METHOD(SlowlyVaryingSeries) {
+			CompressedChunkList<std::int64_t, 64> list;
+			std::vector<std::int64_t> expected;
+			std::int64_t value = 1000000000000ll;
+			for (int i = 0; i < 1000; i++) {
+				value += (i * 7919) % 21 - 10;
+				list.push_back(value);
+				expected.push_back(value);
+			}
+			CompressionStats stats = list.stats();
+			Assert::IsTrue(stats.chunks == 16);
+			Assert::IsTrue(stats.delta_varint_chunks + stats.bit_packed_chunks == 15);
+			Assert::IsTrue(stats.stored_bytes * 4 < stats.raw_bytes);
+			Assert::IsTrue(stats.saved_bytes() > 0);
+
+			for (int i = 999; i >= 0; i--)
+				Assert::IsTrue(list[i] == expected[i]);
+			std::size_t index = 0;
+			list.for_each([&index, &expected](std::int64_t v) {
+				Assert::IsTrue(v == expected[index++]);
+				});
+			Assert::IsTrue(index == 1000);
+		}
+
+		TEST_METHOD(EncodingsRoundTrip) {
+			// Narrow band around a large base packs to a few bits per value
+			CompressedChunkList<std::int64_t, 64> band;
+			for (int i = 0; i < 128; i++)
+				band.push_back(-5000000000ll + (i * 37) % 13);
+			Assert::IsTrue(band.stats().bit_packed_chunks == 2);
+			for (int i = 0; i < 128; i++)
+				Assert::IsTrue(band[i] == -5000000000ll + (i * 37) % 13);
+
+			// Values all over the range do not compress
+			CompressedChunkList<std::uint64_t, 64> noise;
+			std::uint64_t x = 88172645463325252ull;
+			std::vector<std::uint64_t> expected;
+			for (int i = 0; i < 64; i++) {
+				x ^= x << 13;
+				x ^= x >> 7;
+				x ^= x << 17;
+				noise.push_back(x);
+				expected.push_back(x);
+			}
+			Assert::IsTrue(noise.stats().saved_bytes() == 0);
+			for (int i = 0; i < 64; i++)
+				Assert::IsTrue(noise[i] == expected[i]);
+		}
+
+		TEST_METHOD(SetUnsealsChunk) {
+			CompressedChunkList<int, 16> list;
+			for (int i = 0; i < 40; i++)
+				list.push_back(i);
+			std::size_t compressed = list.stats().stored_bytes;
+			list.set(3, -3);
+			Assert::IsTrue(list[3] == -3);
+			Assert::IsTrue(list[4] == 4);
+			Assert::IsTrue(list.stats().stored_bytes > compressed);
+			list.compress_sealed();
+			Assert::IsTrue(list[3] == -3);
+			Assert::IsTrue(list.stats().stored_bytes <= compressed + 8);
+
+			for (int i = 0; i < 25; i++)
+				list.pop_back();
+			Assert::IsTrue(list.size() == 15);
+			Assert::IsTrue(list.back() == 14);
+			list.push_back(15);
+			Assert::IsTrue(list.chunk_count() == 1);
+			Assert::IsTrue(list.stats().stored_bytes < 16 * sizeof(int));
+			Assert::ExpectException<std::out_of_range>([&list]() { list.set(16, 0); });
+		}
+	};
+
+#ifndef _WIN32
+	/// @brief Creates an empty temporary file and returns its path.
+	static std::string temporary_path() {
+		char path[] = "/tmp/chunklist_test_XXXXXX";
+		int fd = mkstemp(path);
+		close(fd);
+		return path;
+	}
+
+	TEST_CLASS(MappedChunkListTests) {
+		TEST_METHOD(ReopenWithoutDeserialization) {
+			std::string path = temporary_path();
+			{
+				MappedChunkList<int, 16> list(path);
+				for (int i = 0; i < 1000; i++)
+					list.push_back(i);
+				list.pop_back();
+			}
+			{
+				MappedChunkList<int, 16> list(path);
+				Assert::IsTrue(list.size() == 999);
+				Assert::IsTrue(list.chunk_count() == 63);
+				for (int i = 0; i < 999; i++)
+					Assert::IsTrue(list[i] == i);
+				list.clear();
+				list.push_back(5);
+				// The committed chunks are not reused before the next sync
+				Assert::IsTrue(list.chunk_count() == 64);
+				list.clear();
+				list.sync();
+				list.push_back(6);
+				list.pop_back();
+				list.push_back(5);
+				Assert::IsTrue(list.chunk_count() == 64);
+				Assert::IsTrue(list.back() == 5);
+			}
+			unlink(path.c_str());
+		}
+
+		TEST_METHOD(RollbackToLastSync) {
+			std::string path = temporary_path();
+			pid_t child = fork();
+			if (child == 0) {
+				// Dies without running destructors after appending past the sync point
+				MappedChunkList<int, 16> list(path);
+				for (int i = 0; i < 100; i++)
+					list.push_back(i);
+				list.sync();
+				for (int i = 100; i < 10000; i++)
+					list.push_back(i);
+				_exit(0);
+			}
+			int status = 0;
+			waitpid(child, &status, 0);
+
+			MappedChunkList<int, 16> list(path);
+			Assert::IsTrue(list.size() == 100);
+			Assert::IsTrue(list.back() == 99);
+			list.push_back(100);
+			Assert::IsTrue(list[100] == 100);
+			unlink(path.c_str());
+		}
+
+		TEST_METHOD(RollbackAfterShrinking) {
+			std::string path = temporary_path();
+			{
+				MappedChunkList<int, 4> list(path);
+				for (int i = 0; i < 12; i++)
+					list.push_back(i);
+				list.sync();
+			}
+			// Each child dies without running destructors after overwriting
+			// committed positions
+			auto crash = [&path](auto modify) {
+				pid_t child = fork();
+				if (child == 0) {
+					MappedChunkList<int, 4> list(path);
+					modify(list);
+					_exit(0);
+				}
+				int status = 0;
+				waitpid(child, &status, 0);
+			};
+			crash([](MappedChunkList<int, 4>& list) {
+				list.clear();
+				list.push_back(99);
+				});
+			crash([](MappedChunkList<int, 4>& list) {
+				for (int i = 0; i < 6; i++)
+					list.pop_back();
+				for (int i = 0; i < 9; i++)
+					list.push_back(100 + i);
+				});
+
+			MappedChunkList<int, 4> list(path);
+			Assert::IsTrue(list.size() == 12);
+			std::vector<int> elements;
+			list.for_each([&elements](int v) { elements.push_back(v); });
+			Assert::IsTrue(elements == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 });
+			list.pop_back();
+			list.push_back(12);
+			Assert::IsTrue(list.back() == 12 && list[10] == 10);
+			unlink(path.c_str());
+		}
+
+		TEST_METHOD(RejectsOtherLayout) {
+			std::string path = temporary_path();
+			{
+				MappedChunkList<int, 16> list(path);
+				list.push_back(1);
+			}
+			Assert::ExpectException<std::runtime_error>([&path]() {
+				MappedChunkList<int, 32> list(path);
+				});
+			unlink(path.c_str());
+		}
+	};
+
+	TEST_CLASS(SerializationTests) {
+		TEST_METHOD(RoundTripTriviallyCopyable) {
+			std::string path = temporary_path();
+			ChunkList<int, 16> list;
+			for (int i = 0; i < 1000; i++)
+				list.push_back(i * 7);
+			int fd = open(path.c_str(), O_WRONLY | O_TRUNC);
+			save(fd, list);
+			close(fd);
+
+			fd = open(path.c_str(), O_RDONLY);
+			ChunkList<int, 64> loaded;
+			loaded.push_back(-1);
+			load(fd, loaded);
+			close(fd);
+			Assert::IsTrue(loaded.size() == 1000);
+			for (int i = 0; i < 1000; i++)
+				Assert::IsTrue(loaded[i] == i * 7);
+			unlink(path.c_str());
+		}
+
+		TEST_METHOD(RoundTripWithCodec) {
+			std::string path = temporary_path();
+			ChunkList<std::string, 4> list;
+			for (int i = 0; i < 50; i++)
+				list.push_back(std::string(i, 'a' + i % 26));
+			int fd = open(path.c_str(), O_WRONLY | O_TRUNC);
+			save(fd, list);
+			close(fd);
+
+			fd = open(path.c_str(), O_RDONLY);
+			ChunkListLoader<std::string> loader(fd);
+			Assert::IsTrue(loader.size() == 50);
+			Assert::IsTrue(loader.chunk_size() == 4);
+			ChunkList<std::string, 4> loaded;
+			Assert::IsTrue(loader.load_next_chunk(loaded));
+			Assert::IsTrue(loaded.size() == 4);
+			while (loader.load_next_chunk(loaded)) {
+			}
+			close(fd);
+			Assert::IsTrue(loaded.size() == 50);
+			for (int i = 0; i < 50; i++)
+				Assert::IsTrue(loaded[i] == list[i]);
+			unlink(path.c_str());
+		}
+
+		TEST_METHOD(DetectsDamagedBlock) {
+			std::string path = temporary_path();
+			ChunkList<int, 16> list;
+			for (int i = 0; i < 100; i++)
+				list.push_back(i);
+			int fd = open(path.c_str(), O_RDWR | O_TRUNC);
+			save(fd, list);
+
+			// Flips a byte in the payload of the fourth block
+			off_t block_bytes = sizeof(chunk_format::BlockHeader) + 16 * sizeof(int);
+			off_t damaged = sizeof(chunk_format::FileHeader) + 3 * block_bytes + sizeof(chunk_format::BlockHeader) + 5;
+			char byte;
+			pread(fd, &byte, 1, damaged);
+			byte ^= 0x10;
+			pwrite(fd, &byte, 1, damaged);
+			lseek(fd, 0, SEEK_SET);
+
+			ChunkList<int, 16> loaded;
+			Assert::ExpectException<std::runtime_error>([&fd, &loaded]() {
+				load(fd, loaded);
+				});
+			close(fd);
+			Assert::IsTrue(loaded.size() == 48);
+			Assert::IsTrue(loaded.back() == 47);
+			unlink(path.c_str());
+		}
+
+		TEST_METHOD(GatherWriteScatterRead) {
+			std::string path = temporary_path();
+			// More chunks than fit in one writev call
+			ChunkList<int, 4> list;
+			for (int i = 0; i < 5000; i++)
+				list.push_back(i);
+			int batches = 0;
+			for_each_iovec_batch(list, [&batches](iovec*, int) { batches++; });
+			Assert::IsTrue(batches > 1);
+
+			int fd = open(path.c_str(), O_RDWR | O_TRUNC);
+			gather_write(fd, list);
+			gather_pwrite(fd, list, 5000 * sizeof(int));
+			lseek(fd, 0, SEEK_SET);
+
+			ChunkList<int, 64> loaded;
+			loaded.push_back(-1);
+			loaded.extend(10000);
+			Assert::IsTrue(loaded.size() == 10001);
+			scatter_read(fd, loaded, 1);
+			close(fd);
+			Assert::IsTrue(loaded[0] == -1);
+			for (int i = 0; i < 10000; i++)
+				Assert::IsTrue(loaded[i + 1] == i % 5000);
+
+			fd = open(path.c_str(), O_RDONLY);
+			loaded.extend(1);
+			Assert::ExpectException<std::runtime_error>([&fd, &loaded]() {
+				scatter_read(fd, loaded, 1);
+				});
+			close(fd);
+			unlink(path.c_str());
+		}
+
+		TEST_METHOD(RejectsOtherElementType) {
+			std::string path = temporary_path();
+			ChunkList<int, 16> list = { 1, 2, 3 };
+			int fd = open(path.c_str(), O_WRONLY | O_TRUNC);
+			save(fd, list);
+			close(fd);
+
+			fd = open(path.c_str(), O_RDONLY);
+			ChunkList<long long, 16> loaded;
+			Assert::ExpectException<std::runtime_error>([&fd, &loaded]() {
+				load(fd, loaded);
+				});
+			close(fd);
+			unlink(path.c_str());
+		}
+	};
+
+	TEST_CLASS(SpillChunkListTests) {
+		TEST_METHOD(EvictsOverBudget) {
+			std::string path = temporary_path();
+			SpillChunkList<int, 16> list(path, 4 * 16 * sizeof(int));
+			for (int i = 0; i < 10000; i++)
+				list.push_back(i);
+			Assert::IsTrue(list.size() == 10000);
+			Assert::IsTrue(list.chunk_count() == 625);
+			Assert::IsTrue(list.resident_chunks() <= 4);
+			Assert::IsTrue(list.stats().writebacks > 0);
+
+			// Random access faults chunks back in
+			for (int i = 9999; i >= 0; i -= 37)
+				Assert::IsTrue(list.at(i) == i);
+			list[5] = -5;
+			list[9000] = -9000;
+			for (int i = 0; i < 10000; i += 500)
+				list.at(i);
+			Assert::IsTrue(list[5] == -5);
+			Assert::IsTrue(list[9000] == -9000);
+			Assert::IsTrue(list.resident_bytes() <= list.budget_bytes());
+			Assert::ExpectException<std::out_of_range>([&list]() { list.at(10000); });
+		}
+
+		TEST_METHOD(ReadsAheadOfScan) {
+			std::string path = temporary_path();
+			SpillChunkList<int, 16> list(path, 8 * 16 * sizeof(int), 3);
+			for (int i = 0; i < 4000; i++)
+				list.push_back(i);
+			long long sum = 0;
+			list.for_each([&sum](int value) { sum += value; });
+			Assert::IsTrue(sum == 4000ll * 3999 / 2);
+			Assert::IsTrue(list.stats().prefetches > 0);
+			Assert::IsTrue(list.stats().prefetch_hits > 0);
+			Assert::IsTrue(list.resident_chunks() <= 8);
+
+			for (int i = 0; i < 4000; i++)
+				Assert::IsTrue(list[i] == i);
+		}
+
+		TEST_METHOD(PopBackAcrossEvictedChunks) {
+			std::string path = temporary_path();
+			SpillChunkList<int, 16> list(path, 2 * 16 * sizeof(int));
+			for (int i = 0; i < 100; i++)
+				list.push_back(i);
+			list.front();
+			for (int i = 0; i < 60; i++)
+				list.pop_back();
+			Assert::IsTrue(list.size() == 40);
+			Assert::IsTrue(list.chunk_count() == 3);
+			Assert::IsTrue(list.back() == 39);
+			list.push_back(1000);
+			Assert::IsTrue(list.back() == 1000);
+			Assert::IsTrue(list[39] == 39);
+			list.clear();
+			Assert::IsTrue(list.empty());
+			Assert::ExpectException<std::invalid_argument>([&path]() {
+				SpillChunkList<int, 16> tiny(path, 16);
+				});
+		}
+	};
+
+	TEST_CLASS(SharedChunkListTests) {
+		TEST_METHOD(PublishesSealedChunks) {
+			const std::string name = "/chunklist_test_publish";
+			SharedChunkList<int, 16> list(name);
+			SharedChunkListReader<int, 16> reader(name);
+			Assert::IsTrue(reader.size() == 0);
+
+			for (int i = 0; i < 20; i++)
+				list.push_back(i);
+			Assert::IsTrue(list.published_size() == 16);
+			Assert::IsTrue(reader.size() == 0);
+			Assert::IsTrue(reader.refresh() == 16);
+			Assert::IsTrue(reader[15] == 15);
+			Assert::ExpectException<std::out_of_range>([&reader]() { reader.at(16); });
+
+			list.publish();
+			Assert::IsTrue(reader.refresh() == 20);
+			Assert::IsTrue(reader.at(19) == 19);
+
+			// Grows the segment past the reader's mapping
+			for (int i = 20; i < 100000; i++)
+				list.push_back(i);
+			list.publish();
+			Assert::IsTrue(reader.refresh() == 100000);
+			long long sum = 0;
+			reader.for_each([&sum](int value) { sum += value; });
+			Assert::IsTrue(sum == 100000ll * 99999 / 2);
+			Assert::IsTrue(reader[99999] == 99999);
+			SharedChunkList<int, 16>::remove(name);
+		}
+
+		TEST_METHOD(ReaderInOtherProcess) {
+			const std::string name = "/chunklist_test_reader";
+			SharedChunkList<int, 16> list(name);
+			pid_t child = fork();
+			if (child == 0) {
+				// Reads concurrently and checks every published prefix
+				SharedChunkListReader<int, 16> reader(name);
+				while (reader.refresh() < 50000) {
+					for (std::size_t i = 0; i < reader.size(); i += 997)
+						if (reader[i] != static_cast<int>(i) * 3)
+							_exit(1);
+				}
+				for (std::size_t i = 0; i < reader.size(); i++)
+					if (reader[i] != static_cast<int>(i) * 3)
+						_exit(1);
+				_exit(0);
+			}
+			for (int i = 0; i < 50000; i++)
+				list.push_back(i * 3);
+			list.publish();
+			int status = 0;
+			waitpid(child, &status, 0);
+			Assert::IsTrue(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+			SharedChunkList<int, 16>::remove(name);
+		}
+
+		TEST_METHOD(ReaderRejectsOtherLayout) {
+			const std::string name = "/chunklist_test_layout";
+			SharedChunkList<int, 16> list(name);
+			Assert::ExpectException<std::runtime_error>([&name]() {
+				SharedChunkListReader<int, 32> reader(name);
+				});
+			SharedChunkList<int, 16>::remove(name);
+		}
+	};
+#endif
+}
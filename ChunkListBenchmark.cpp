@@ -0,0 +1,280 @@
+// ChunkListBenchmark.cpp: memory and speed of ChunkList under different chunk
+// size policies, scan throughput of compressed chunks, range filters and
+// range sums with per-chunk summaries, and sequential scans of a list much
+// larger than the last-level cache at several prefetch distances.
+//
+// Build: g++ -std=c++20 -O2 -I. ChunkListBenchmark.cpp -o chunklist_bench
+
+#include "Chunk.h"
+#include "ChunkSummaries.h"
+#include "CompressedChunkList.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace fefu_laboratory_two;
+
+namespace {
+	/// @brief Allocator counting the bytes of chunk payloads in use.
+	template <typename T>
+	class CountingAllocator : public Allocator<T> {
+	public:
+		static inline std::size_t bytes = 0;
+
+		CountingAllocator() = default;
+
+		template <class U>
+		CountingAllocator(const CountingAllocator<U>&) noexcept {};
+
+		T* allocate(std::size_t n) {
+			bytes += n * sizeof(T);
+			return Allocator<T>::allocate(n);
+		}
+
+		void deallocate(T* p, std::size_t n) noexcept {
+			bytes -= n * sizeof(T);
+			Allocator<T>::deallocate(p, n);
+		}
+	};
+
+	using Clock = std::chrono::steady_clock;
+
+	double elapsed_ms(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	/// @brief Bytes held by a list: chunk payloads, chunk headers and the list
+	/// object itself.
+	template <typename List>
+	std::size_t footprint(const List& list, std::size_t payload) {
+		using chunk_type = Chunk<typename List::value_type, typename List::allocator_type>;
+		return payload + list.chunk_count() * sizeof(chunk_type) + sizeof(List);
+	}
+
+	template <typename List>
+	void run(const char* name, const List& prototype) {
+		using allocator = typename List::allocator_type;
+		const std::size_t small_lists = 100000;
+		const std::size_t small_size = 10;
+		const std::size_t large_size = 1 << 20;
+		const std::size_t lookups = 2000;
+
+		// Many small lists
+		allocator::bytes = 0;
+		auto start = Clock::now();
+		std::size_t small_bytes = 0;
+		{
+			std::vector<List> lists(small_lists, prototype);
+			for (auto& list : lists)
+				for (std::size_t i = 0; i < small_size; i++)
+					list.push_back(static_cast<int>(i));
+			for (auto& list : lists)
+				small_bytes += footprint(list, 0);
+			small_bytes += allocator::bytes;
+		}
+		double small_ms = elapsed_ms(start);
+
+		// One large list
+		allocator::bytes = 0;
+		List list(prototype);
+		start = Clock::now();
+		for (std::size_t i = 0; i < large_size; i++)
+			list.push_back(static_cast<int>(i));
+		double push_ms = elapsed_ms(start);
+		std::size_t large_bytes = footprint(list, allocator::bytes);
+
+		std::mt19937 rng(42);
+		std::uniform_int_distribution<std::size_t> dist(0, large_size - 1);
+		long long sum = 0;
+		start = Clock::now();
+		for (std::size_t i = 0; i < lookups; i++)
+			sum += list.at(dist(rng));
+		double at_ms = elapsed_ms(start);
+
+		std::printf("%-24s %10.1f %14.1f %10.2f %10zu %10.2f %12.4f  (%lld)\n",
+			name,
+			static_cast<double>(small_bytes) / small_lists,
+			small_ms,
+			static_cast<double>(large_bytes) / large_size,
+			list.chunk_count(),
+			push_ms,
+			at_ms * 1000.0 / lookups,
+			sum);
+	}
+
+	/// @brief Scans a slowly varying int64 series stored raw and compressed.
+	void run_compression() {
+		const std::size_t count = 1 << 22;
+		const int scans = 10;
+
+		ChunkList<std::int64_t> raw;
+		CompressedChunkList<std::int64_t> compressed;
+		std::mt19937 rng(7);
+		std::uniform_int_distribution<int> step(-50, 50);
+		std::int64_t value = 1700000000000ll;
+		for (std::size_t i = 0; i < count; i++) {
+			value += step(rng);
+			raw.push_back(value);
+			compressed.push_back(value);
+		}
+
+		std::int64_t raw_sum = 0;
+		auto start = Clock::now();
+		for (int s = 0; s < scans; s++)
+			for (auto* chunk = raw.front_chunk(); chunk != nullptr; chunk = chunk->next)
+				for (std::int64_t* el = chunk->begin(); el != chunk->end(); el++)
+					raw_sum += *el;
+		double raw_ms = elapsed_ms(start);
+
+		std::int64_t compressed_sum = 0;
+		start = Clock::now();
+		for (int s = 0; s < scans; s++)
+			compressed.for_each([&compressed_sum](std::int64_t v) { compressed_sum += v; });
+		double compressed_ms = elapsed_ms(start);
+
+		CompressionStats stats = compressed.stats();
+		double scanned_mb = static_cast<double>(count * sizeof(std::int64_t) * scans) / (1 << 20);
+		std::printf("\n%-24s %10s %12s %12s\n", "int64 random walk", "MB", "scan MB/s", "checksum");
+		std::printf("%-24s %10.1f %12.0f %12lld\n", "raw",
+			static_cast<double>(count * sizeof(std::int64_t)) / (1 << 20), scanned_mb * 1000.0 / raw_ms,
+			static_cast<long long>(raw_sum));
+		std::printf("%-24s %10.1f %12.0f %12lld\n", "compressed",
+			static_cast<double>(stats.stored_bytes) / (1 << 20), scanned_mb * 1000.0 / compressed_ms,
+			static_cast<long long>(compressed_sum));
+		std::printf("saved %.1f%%, %zu delta/varint and %zu bit-packed of %zu chunks\n",
+			100.0 * static_cast<double>(stats.saved_bytes()) / static_cast<double>(stats.raw_bytes),
+			stats.delta_varint_chunks, stats.bit_packed_chunks, stats.chunks);
+	}
+
+	/// @brief Counts a narrow window of an increasing series with and without
+	/// per-chunk zone maps.
+	template <class List>
+	void run_range_filter(const char* name) {
+		const std::size_t count = 1 << 22;
+		const int queries = 200;
+
+		List list;
+		std::mt19937 rng(11);
+		std::int64_t value = 0;
+		for (std::size_t i = 0; i < count; i++) {
+			value += rng() % 8;
+			list.push_back(value);
+		}
+
+		std::size_t matched = 0;
+		auto start = Clock::now();
+		for (int q = 0; q < queries; q++) {
+			std::int64_t lo = static_cast<std::int64_t>(rng() % static_cast<std::uint64_t>(value));
+			matched += list.count_in_range(lo, lo + 10000);
+		}
+		double ms = elapsed_ms(start);
+		std::printf("%-24s %12.3f %12zu\n", name, ms * 1000.0 / queries, matched);
+	}
+
+	void run_range_filters() {
+		std::printf("\n%-24s %12s %12s\n", "range filter", "query us", "matched");
+		run_range_filter<ChunkList<std::int64_t>>("full scan");
+		run_range_filter<ZoneMappedChunkList<std::int64_t>>("zone maps");
+	}
+
+	/// @brief Sums random index ranges with and without cached chunk
+	/// aggregates.
+	template <class List>
+	void run_range_sum(const char* name) {
+		const std::size_t count = 1 << 22;
+		const int queries = 200;
+
+		List list;
+		std::mt19937 rng(13);
+		for (std::size_t i = 0; i < count; i++)
+			list.push_back(static_cast<std::int64_t>(rng() % 1000));
+
+		std::int64_t total = 0;
+		auto start = Clock::now();
+		for (int q = 0; q < queries; q++) {
+			std::size_t first = rng() % count;
+			std::size_t last = first + rng() % (count - first);
+			total += list.range_sum(first, last);
+		}
+		double ms = elapsed_ms(start);
+		std::printf("%-24s %12.3f %12lld\n", name, ms * 1000.0 / queries, static_cast<long long>(total));
+	}
+
+	void run_range_sums() {
+		std::printf("\n%-24s %12s %12s\n", "range sum", "query us", "checksum");
+		run_range_sum<ChunkList<std::int64_t>>("full scan");
+		run_range_sum<AggregatedChunkList<std::int64_t>>("cached aggregates");
+	}
+
+	/// @brief Scans a 256 MB list whose chunks are scattered over the heap with
+	/// the iterators, segment by segment and with count_in_range.
+	void run_prefetch() {
+		using List = ChunkList<std::int64_t, 64>;
+		const std::size_t chunks = 1 << 19;
+		const std::size_t builders = 64;
+		const int scans = 3;
+
+		// Whole chunks are pushed to randomly chosen lists, so consecutive
+		// chunks of the final list come from unrelated allocations, then the
+		// lists are relinked into one
+		std::vector<List> parts(builders);
+		std::mt19937 rng(17);
+		std::int64_t value = 0;
+		for (std::size_t c = 0; c < chunks; c++) {
+			List& part = parts[rng() % builders];
+			for (int i = 0; i < 64; i++)
+				part.push_back(value++);
+		}
+		List list;
+		for (List& part : parts)
+			list.append(std::move(part));
+
+		std::printf("\n%-24s %12s %12s %12s %12s\n", "prefetch distance", "iterator ms", "segments ms", "count ms", "checksum");
+		for (std::size_t distance : { 0, 1, 2, 4, 8 }) {
+			prefetch_distance = distance;
+			double iterator_ms = 0, segments_ms = 0, count_ms = 0;
+			std::int64_t sum = 0;
+			for (int s = 0; s < scans; s++) {
+				auto start = Clock::now();
+				for (std::int64_t v : std::as_const(list))
+					sum += v;
+				iterator_ms += elapsed_ms(start);
+
+				start = Clock::now();
+				for_each_segmented(std::as_const(list), [&sum](std::int64_t v) { sum += v; });
+				segments_ms += elapsed_ms(start);
+
+				start = Clock::now();
+				sum += static_cast<std::int64_t>(list.count_in_range(0, value / 2));
+				count_ms += elapsed_ms(start);
+			}
+			std::printf("%-24zu %12.1f %12.1f %12.1f %12lld\n", distance,
+				iterator_ms / scans, segments_ms / scans, count_ms / scans, static_cast<long long>(sum));
+		}
+		prefetch_distance = 2;
+	}
+}
+
+int main() {
+	using A = CountingAllocator<int>;
+
+	std::printf("%-24s %10s %14s %10s %10s %10s %12s\n",
+		"policy", "small B/ls", "small ms", "large B/el", "chunks", "push ms", "at() us");
+
+	run("fixed 16", ChunkList<int, 16, A>());
+	run("fixed 1024", ChunkList<int, 1024, A>());
+	run("runtime 16", RuntimeChunkList<int, 16, A>(RuntimeChunkSize<16>(16)));
+	run("runtime 1000", RuntimeChunkList<int, 16, A>(RuntimeChunkSize<16>(1000)));
+	run("runtime 1024", RuntimeChunkList<int, 16, A>(RuntimeChunkSize<16>(1024)));
+	run("geometric 16..1024", GeometricChunkList<int, 16, 1024, A>());
+	run("geometric 16..65536", GeometricChunkList<int, 16, 65536, A>());
+	run("inline 16 + fixed 1024", SmallChunkList<int, 16, 1024, A>());
+
+	run_compression();
+	run_range_filters();
+	run_range_sums();
+	run_prefetch();
+	return 0;
+}
@@ -0,0 +1,592 @@
+#pragma once
+#include "Chunk.h"
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <iterator>
+
+
+namespace fefu_laboratory_two {
+	/// @brief ChunkList of flags packed 64 to a word.
+	///
+	/// Like std::vector<bool>, elements are bits rather than objects: element
+	/// access and the iterators return a proxy reference, and the list does
+	/// not implement ChunkListInterface<bool> nor segments(). Each chunk holds
+	/// N flags. Bits past the last flag of a chunk are always zero, so count(),
+	/// the find functions and the bulk operations work a word at a time with
+	/// popcount and count trailing zeros, and insert and erase shift whole
+	/// words.
+	/// @tparam N number of flags in a chunk
+	template <std::size_t N, typename Allocator, typename SizePolicy, std::size_t InlineN, typename Summary>
+	class ChunkList<bool, N, Allocator, SizePolicy, InlineN, Summary> {
+		static_assert(std::is_same_v<SizePolicy, FixedChunkSize<N>> && InlineN == 0,
+			"Lists of bool only support fixed-size chunks");
+		static_assert(std::is_same_v<Summary, NoSummary>, "Lists of bool keep no chunk summaries");
+	public:
+		using value_type = bool;
+		using allocator_type = Allocator;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using const_reference = bool;
+		using word_type = std::uint64_t;
+
+		/// @brief Returned by the find functions when no flag is set.
+		static constexpr size_type npos = static_cast<size_type>(-1);
+
+		static constexpr size_type bits_per_word = 64;
+		static constexpr size_type words_per_chunk = (N + bits_per_word - 1) / bits_per_word;
+
+		template <bool Const>
+		class bit_iterator;
+
+		/// @brief Proxy standing for one flag.
+		class reference {
+		public:
+			operator bool() const noexcept { return (*word & mask) != 0; }
+
+			reference& operator=(bool value) noexcept {
+				if (value)
+					*word |= mask;
+				else
+					*word &= ~mask;
+				return *this;
+			}
+
+			reference& operator=(const reference& other) noexcept {
+				return *this = static_cast<bool>(other);
+			}
+
+			/// @brief Assigns through a const proxy, which makes the iterators
+			/// indirectly writable for the std::ranges algorithms.
+			const reference& operator=(bool value) const noexcept {
+				if (value)
+					*word |= mask;
+				else
+					*word &= ~mask;
+				return *this;
+			}
+
+			void flip() noexcept { *word ^= mask; }
+
+		private:
+			friend class ChunkList;
+			template <bool Const>
+			friend class bit_iterator;
+
+			reference(word_type* word, word_type mask) noexcept : word(word), mask(mask) {}
+
+			word_type* word;
+			word_type mask;
+		};
+
+	private:
+		using word_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<word_type>;
+		using chunk_type = Chunk<word_type, word_allocator>;
+
+	public:
+		/// @brief Random access iterator over the flags. Remembers the chunk of
+		/// its position, so stepping and short moves never walk the list; longer
+		/// moves locate the chunk again.
+		/// @tparam Const whether the iterator only reads the flags
+		template <bool Const>
+		class bit_iterator {
+		public:
+			using iterator_concept = std::random_access_iterator_tag;
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = bool;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = std::conditional_t<Const, bool, typename ChunkList::reference>;
+
+			bit_iterator() = default;
+
+			/// @brief Converts an iterator to a const iterator.
+			template <bool OtherConst>
+				requires (Const && !OtherConst)
+			bit_iterator(const bit_iterator<OtherConst>& other) noexcept
+				: list(other.list), chunk(other.chunk), chunk_start(other.chunk_start), pos(other.pos)
+			{
+			}
+
+			reference operator*() const noexcept {
+				size_type offset = pos - chunk_start;
+				word_type mask = word_type(1) << (offset % bits_per_word);
+				if constexpr (Const)
+					return (chunk->list[offset / bits_per_word] & mask) != 0;
+				else
+					return reference(chunk->list + offset / bits_per_word, mask);
+			}
+
+			reference operator[](difference_type n) const { return *(*this + n); }
+
+			bit_iterator& operator++() {
+				seek(pos + 1);
+				return *this;
+			}
+
+			bit_iterator operator++(int) {
+				bit_iterator result = *this;
+				++*this;
+				return result;
+			}
+
+			bit_iterator& operator--() {
+				seek(pos - 1);
+				return *this;
+			}
+
+			bit_iterator operator--(int) {
+				bit_iterator result = *this;
+				--*this;
+				return result;
+			}
+
+			bit_iterator& operator+=(difference_type n) {
+				seek(static_cast<size_type>(static_cast<difference_type>(pos) + n));
+				return *this;
+			}
+
+			bit_iterator& operator-=(difference_type n) { return *this += -n; }
+
+			friend bit_iterator operator+(bit_iterator it, difference_type n) { return it += n; }
+			friend bit_iterator operator+(difference_type n, bit_iterator it) { return it += n; }
+			friend bit_iterator operator-(bit_iterator it, difference_type n) { return it -= n; }
+
+			friend difference_type operator-(const bit_iterator& lhs, const bit_iterator& rhs) noexcept {
+				return static_cast<difference_type>(lhs.pos) - static_cast<difference_type>(rhs.pos);
+			}
+
+			friend bool operator==(const bit_iterator& lhs, const bit_iterator& rhs) noexcept { return lhs.pos == rhs.pos; }
+
+			friend auto operator<=>(const bit_iterator& lhs, const bit_iterator& rhs) noexcept { return lhs.pos <=> rhs.pos; }
+
+		private:
+			friend class ChunkList;
+			template <bool>
+			friend class bit_iterator;
+
+			using list_type = std::conditional_t<Const, const ChunkList, ChunkList>;
+
+			bit_iterator(list_type* list, size_type pos) : list(list) { seek(pos); }
+
+			/// @brief Moves to target, following one link when it is in the
+			/// chunk next to the current one. Positions past the last chunk have
+			/// no chunk.
+			void seek(size_type target) {
+				if (chunk != nullptr && target >= chunk_start && target - chunk_start < N) {
+				}
+				else if (chunk != nullptr && target == chunk_start + N && chunk->next != nullptr) {
+					chunk = chunk->next;
+					chunk_start += N;
+				}
+				else if (chunk != nullptr && target + 1 == chunk_start && chunk->prev != nullptr) {
+					chunk = chunk->prev;
+					chunk_start -= N;
+				}
+				else if (target < list->num_of_chunks * N) {
+					size_type offset;
+					list->locate(target, chunk, offset);
+					chunk_start = target - offset;
+				}
+				else
+					chunk = nullptr;
+				pos = target;
+			}
+
+			list_type* list = nullptr;
+			chunk_type* chunk = nullptr;
+			size_type chunk_start = 0;
+			size_type pos = 0;
+		};
+
+		using iterator = bit_iterator<false>;
+		using const_iterator = bit_iterator<true>;
+
+		ChunkList() {};
+
+		/// @param count the size of the container
+		/// @param value the value to initialize the flags with
+		explicit ChunkList(size_type count, bool value = false, const Allocator& alloc = Allocator())
+			: allocator(alloc)
+		{
+			resize(count, value);
+		};
+
+		ChunkList(std::initializer_list<bool> init, const Allocator& alloc = Allocator())
+			: allocator(alloc)
+		{
+			for (bool value : init)
+				push_back(value);
+		};
+
+		ChunkList(const ChunkList& other) : allocator(other.allocator) {
+			for (chunk_type* chunk = other.first_chunk; chunk != nullptr; chunk = chunk->next)
+				std::copy(chunk->list, chunk->list + words_per_chunk, append_chunk()->list);
+			list_size = other.list_size;
+		};
+
+		ChunkList(ChunkList&& other) noexcept : allocator(other.allocator) {
+			swap(other);
+		};
+
+		~ChunkList() {
+			clear();
+		};
+
+		ChunkList& operator=(ChunkList other) noexcept {
+			swap(other);
+			return *this;
+		};
+
+		/// ELEMENT ACCESS
+
+		/// @throw std::out_of_range
+		reference at(size_type pos) {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @throw std::out_of_range
+		const_reference at(size_type pos) const {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @brief Returns a proxy for the flag at pos. No bounds checking is
+		/// performed.
+		reference operator[](size_type pos) {
+			chunk_type* chunk;
+			size_type offset;
+			locate(pos, chunk, offset);
+			return reference(chunk->list + offset / bits_per_word, word_type(1) << (offset % bits_per_word));
+		};
+
+		/// @brief Returns the flag at pos. No bounds checking is performed.
+		const_reference operator[](size_type pos) const {
+			chunk_type* chunk;
+			size_type offset;
+			locate(pos, chunk, offset);
+			return (chunk->list[offset / bits_per_word] >> (offset % bits_per_word)) & 1;
+		};
+
+		reference front() { return at(0); };
+		const_reference front() const { return at(0); };
+		reference back() { return at(size() - 1); };
+		const_reference back() const { return at(size() - 1); };
+
+		/// ITERATORS
+
+		iterator begin() { return iterator(this, 0); };
+		const_iterator begin() const { return const_iterator(this, 0); };
+		const_iterator cbegin() const { return begin(); };
+		iterator end() { return iterator(this, list_size); };
+		const_iterator end() const { return const_iterator(this, list_size); };
+		const_iterator cend() const { return end(); };
+
+		/// CAPACITY
+
+		bool empty() const noexcept { return list_size == 0; };
+
+		size_type size() const noexcept { return list_size; };
+
+		size_type chunk_count() const noexcept { return num_of_chunks; };
+
+		/// QUERIES
+
+		/// @brief Returns the number of set flags.
+		size_type count() const noexcept {
+			size_type result = 0;
+			for (chunk_type* chunk = first_chunk; chunk != nullptr; chunk = chunk->next)
+				for (size_type i = 0; i < words_per_chunk; i++)
+					result += static_cast<size_type>(std::popcount(chunk->list[i]));
+			return result;
+		};
+
+		/// @brief Returns the position of the first set flag, or npos.
+		size_type find_first() const noexcept {
+			return find_from(0);
+		};
+
+		/// @brief Returns the position of the first set flag after pos, or npos.
+		size_type find_next(size_type pos) const noexcept {
+			return pos + 1 >= list_size ? npos : find_from(pos + 1);
+		};
+
+		/// MODIFIERS
+
+		void push_back(bool value) {
+			size_type offset = list_size - (num_of_chunks == 0 ? 0 : (num_of_chunks - 1) * N);
+			if (num_of_chunks == 0 || offset == N) {
+				append_chunk();
+				offset = 0;
+			}
+			if (value)
+				tail_chunk->list[offset / bits_per_word] |= word_type(1) << (offset % bits_per_word);
+			list_size++;
+		};
+
+		void pop_back() {
+			if (list_size == 0)
+				return;
+			resize(list_size - 1);
+		};
+
+		/// @brief Inserts value before pos, shifting the later flags up a word at
+		/// a time.
+		/// @return Iterator pointing to the inserted flag.
+		iterator insert(const_iterator pos, bool value) {
+			size_type index = pos.pos;
+			push_back(false);
+			chunk_type* chunk;
+			size_type offset;
+			locate(index, chunk, offset);
+			for (bool carry = value; chunk != nullptr; chunk = chunk->next, offset = 0)
+				carry = shift_up(chunk, offset, carry);
+			return iterator(this, index);
+		};
+
+		/// @brief Removes the flag at pos, shifting the later flags down a word
+		/// at a time.
+		/// @return Iterator following the removed flag.
+		iterator erase(const_iterator pos) {
+			size_type index = pos.pos;
+			chunk_type* chunk;
+			size_type offset;
+			locate(index, chunk, offset);
+			for (; chunk != nullptr; chunk = chunk->next, offset = 0)
+				shift_down(chunk, offset, chunk->next != nullptr && (chunk->next->list[0] & 1) != 0);
+			resize(list_size - 1);
+			return iterator(this, index);
+		};
+
+		/// @brief Resizes the container to count flags, setting new ones to value.
+		void resize(size_type count, bool value = false) {
+			if (count < list_size) {
+				while (num_of_chunks > 0 && (num_of_chunks - 1) * N >= count)
+					release_tail();
+				list_size = count;
+				clear_unused_bits();
+				return;
+			}
+			if (!value) {
+				// New chunks are zeroed, only the tail is extended in place
+				while (num_of_chunks * N < count)
+					append_chunk();
+				list_size = count;
+				return;
+			}
+			while (list_size < count)
+				push_back(value);
+		};
+
+		/// @brief Inverts every flag.
+		void flip() noexcept {
+			for (chunk_type* chunk = first_chunk; chunk != nullptr; chunk = chunk->next) {
+				for (size_type i = 0; i < words_per_chunk; i++)
+					chunk->list[i] = ~chunk->list[i];
+				clear_bits_from(chunk, N);
+			}
+			clear_unused_bits();
+		};
+
+		void clear() noexcept {
+			while (num_of_chunks > 0)
+				release_tail();
+			list_size = 0;
+		};
+
+		void swap(ChunkList& other) noexcept {
+			std::swap(first_chunk, other.first_chunk);
+			std::swap(tail_chunk, other.tail_chunk);
+			std::swap(list_size, other.list_size);
+			std::swap(num_of_chunks, other.num_of_chunks);
+			std::swap(allocator, other.allocator);
+		};
+
+		/// @brief Flag-wise AND with a list of the same size.
+		/// @throw std::invalid_argument if the sizes differ
+		ChunkList& operator&=(const ChunkList& other) {
+			combine(other, [](word_type a, word_type b) { return a & b; });
+			return *this;
+		};
+
+		/// @brief Flag-wise OR with a list of the same size.
+		/// @throw std::invalid_argument if the sizes differ
+		ChunkList& operator|=(const ChunkList& other) {
+			combine(other, [](word_type a, word_type b) { return a | b; });
+			return *this;
+		};
+
+		/// @brief Flag-wise XOR with a list of the same size.
+		/// @throw std::invalid_argument if the sizes differ
+		ChunkList& operator^=(const ChunkList& other) {
+			combine(other, [](word_type a, word_type b) { return a ^ b; });
+			return *this;
+		};
+
+		friend ChunkList operator&(ChunkList lhs, const ChunkList& rhs) { return lhs &= rhs; };
+		friend ChunkList operator|(ChunkList lhs, const ChunkList& rhs) { return lhs |= rhs; };
+		friend ChunkList operator^(ChunkList lhs, const ChunkList& rhs) { return lhs ^= rhs; };
+
+		friend bool operator==(const ChunkList& lhs, const ChunkList& rhs) noexcept {
+			if (lhs.list_size != rhs.list_size)
+				return false;
+			for (chunk_type *l = lhs.first_chunk, *r = rhs.first_chunk; l != nullptr; l = l->next, r = r->next)
+				if (!std::equal(l->list, l->list + words_per_chunk, r->list))
+					return false;
+			return true;
+		};
+
+	private:
+		friend struct std::hash<ChunkList>;
+
+		void locate(size_type pos, chunk_type*& chunk, size_type& offset) const noexcept {
+			size_type chunk_index;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			if (chunk_index + 1 == num_of_chunks) {
+				chunk = tail_chunk;
+				return;
+			}
+			chunk = first_chunk;
+			while (chunk_index > 0) {
+				chunk = chunk->next;
+				chunk_index--;
+			}
+		}
+
+		/// @brief Links a zeroed chunk after the last one.
+		chunk_type* append_chunk() {
+			chunk_type* chunk = new chunk_type(words_per_chunk, allocator);
+			std::fill(chunk->list, chunk->list + words_per_chunk, word_type(0));
+			chunk->prev = tail_chunk;
+			if (tail_chunk != nullptr)
+				tail_chunk->next = chunk;
+			else
+				first_chunk = chunk;
+			tail_chunk = chunk;
+			num_of_chunks++;
+			return chunk;
+		}
+
+		void release_tail() noexcept {
+			chunk_type* chunk = tail_chunk;
+			tail_chunk = chunk->prev;
+			if (tail_chunk != nullptr)
+				tail_chunk->next = nullptr;
+			else
+				first_chunk = nullptr;
+			delete chunk;
+			num_of_chunks--;
+		}
+
+		/// @brief Zeroes the bits of the last chunk past the last flag.
+		void clear_unused_bits() noexcept {
+			if (num_of_chunks > 0)
+				clear_bits_from(tail_chunk, list_size - (num_of_chunks - 1) * N);
+		}
+
+		static void clear_bits_from(chunk_type* chunk, size_type bit) noexcept {
+			if (bit == words_per_chunk * bits_per_word)
+				return;
+			size_type word = bit / bits_per_word;
+			if (bit % bits_per_word != 0)
+				chunk->list[word++] &= (word_type(1) << (bit % bits_per_word)) - 1;
+			std::fill(chunk->list + word, chunk->list + words_per_chunk, word_type(0));
+		}
+
+		/// @brief Inserts carry at bit, shifting the flags from bit up by one.
+		/// @return The flag shifted out of the end of the chunk.
+		static bool shift_up(chunk_type* chunk, size_type bit, bool carry) noexcept {
+			size_type word = bit / bits_per_word;
+			word_type low = (word_type(1) << (bit % bits_per_word)) - 1;
+			word_type value = chunk->list[word];
+			word_type out = value >> (bits_per_word - 1);
+			chunk->list[word] = (value & low) | ((value & ~low) << 1) | (word_type(carry) << (bit % bits_per_word));
+			while (++word < words_per_chunk) {
+				value = chunk->list[word];
+				chunk->list[word] = (value << 1) | out;
+				out = value >> (bits_per_word - 1);
+			}
+			if constexpr (N % bits_per_word != 0) {
+				// The last flag moved past the chunk, into the unused bits
+				word_type& last = chunk->list[words_per_chunk - 1];
+				out = (last >> (N % bits_per_word)) & 1;
+				last &= ~(word_type(1) << (N % bits_per_word));
+			}
+			return out != 0;
+		}
+
+		/// @brief Removes the flag at bit, shifting the later flags down by one
+		/// and putting incoming in the last flag of the chunk.
+		static void shift_down(chunk_type* chunk, size_type bit, bool incoming) noexcept {
+			size_type word = bit / bits_per_word;
+			word_type low = (word_type(1) << (bit % bits_per_word)) - 1;
+			for (size_type i = word; i < words_per_chunk; i++) {
+				word_type high = i + 1 < words_per_chunk ? chunk->list[i + 1] & 1 : 0;
+				word_type value = chunk->list[i];
+				if (i == word)
+					value = (value & low) | ((value >> 1) & ~low);
+				else
+					value >>= 1;
+				chunk->list[i] = value | (high << (bits_per_word - 1));
+			}
+			chunk->list[words_per_chunk - 1] |= word_type(incoming) << ((N - 1) % bits_per_word);
+		}
+
+		size_type find_from(size_type pos) const noexcept {
+			if (pos >= list_size)
+				return npos;
+			chunk_type* chunk;
+			size_type offset;
+			locate(pos, chunk, offset);
+			size_type chunk_start = pos - offset;
+			size_type word = offset / bits_per_word;
+			word_type bits = chunk->list[word] & (~word_type(0) << (offset % bits_per_word));
+			while (true) {
+				if (bits != 0)
+					return chunk_start + word * bits_per_word + static_cast<size_type>(std::countr_zero(bits));
+				if (++word == words_per_chunk) {
+					chunk = chunk->next;
+					if (chunk == nullptr)
+						return npos;
+					chunk_start += N;
+					word = 0;
+				}
+				bits = chunk->list[word];
+			}
+		}
+
+		template <class Op>
+		void combine(const ChunkList& other, Op op) {
+			if (list_size != other.list_size)
+				throw std::invalid_argument("Lists of flags differ in size");
+			for (chunk_type *l = first_chunk, *r = other.first_chunk; l != nullptr; l = l->next, r = r->next)
+				for (size_type i = 0; i < words_per_chunk; i++)
+					l->list[i] = op(l->list[i], r->list[i]);
+		}
+
+		chunk_type* first_chunk = nullptr;
+		chunk_type* tail_chunk = nullptr;
+		std::size_t list_size = 0;
+		std::size_t num_of_chunks = 0;
+		word_allocator allocator;
+	};
+}  // namespace fefu_laboratory_two
+
+namespace std {
+	/// @brief Hashes the words of the chunks, so lists of flags with equal
+	/// contents and chunk size hash alike.
+	template <std::size_t N, typename Allocator, typename SizePolicy, std::size_t InlineN, typename Summary>
+	struct hash<fefu_laboratory_two::ChunkList<bool, N, Allocator, SizePolicy, InlineN, Summary>> {
+		std::size_t operator()(const fefu_laboratory_two::ChunkList<bool, N, Allocator, SizePolicy, InlineN, Summary>& list) const {
+			fefu_laboratory_two::StreamHash hash;
+			for (auto* chunk = list.first_chunk; chunk != nullptr; chunk = chunk->next)
+				for (std::size_t i = 0; i < list.words_per_chunk; i++)
+					hash.update_word(chunk->list[i]);
+			hash.update_word(list.list_size);
+			return static_cast<std::size_t>(hash.digest());
+		}
+	};
+}  // namespace std
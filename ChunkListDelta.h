@@ -0,0 +1,182 @@
+#pragma once
+#include "Chunk.h"
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace fefu_laboratory_two {
+	/// @brief Chunk summary identifying a chunk and the version of its
+	/// contents, for replicating a list by the chunks that changed.
+	///
+	/// Any write to the chunk clears the version, and delta extraction stamps
+	/// the chunk with a fresh one. Like every chunk summary, the version is
+	/// also cleared by non-const element access, iterators and segments, which
+	/// may write through the references they return: see TrackedChunkList for
+	/// reading without resending. Ids and versions are drawn from counters
+	/// shared by all lists, so they stay unique when chunks are relinked from
+	/// one list into another. An emptied chunk gets a new id.
+	struct ChunkVersion {
+		static constexpr bool enabled = true;
+
+		std::uint64_t id = 0;
+		std::uint64_t version = 0;
+
+		template <typename T>
+		void add(const T&) noexcept { version = 0; }
+
+		template <typename T>
+		void remove(const T&) noexcept { version = 0; }
+
+		void invalidate() noexcept { version = 0; }
+
+		bool stale() const noexcept { return false; }
+
+		template <typename T>
+		void rebuild(const T*, const T*) noexcept {}
+
+		/// @brief Gives the chunk an id and a version if it has none.
+		void stamp(std::uint64_t now) noexcept {
+			if (id == 0)
+				id = next_id.fetch_add(1, std::memory_order_relaxed);
+			if (version == 0)
+				version = now;
+		}
+
+		/// @brief Returns a version newer than every stamp handed out so far.
+		static std::uint64_t next_version() noexcept {
+			return clock.fetch_add(1, std::memory_order_relaxed);
+		}
+
+	private:
+		static inline std::atomic<std::uint64_t> next_id{ 1 };
+		static inline std::atomic<std::uint64_t> clock{ 1 };
+	};
+
+	/// @brief Changes of a list since the state a replica holds: the ids of all
+	/// chunks in order, which covers chunks appended, dropped, split off or
+	/// relinked, and the contents of the chunks the replica does not have.
+	template <typename T>
+	struct ChunkListDelta {
+		std::uint64_t version = 0;
+		std::size_t size = 0;
+		std::vector<std::uint64_t> order;
+		std::vector<std::pair<std::uint64_t, std::vector<T>>> chunks;
+	};
+
+	/// @brief Takes deltas of a list for one replica. The tracker remembers the
+	/// version of every chunk it has sent, so a chunk is sent again only when
+	/// it was written since, or when it is new to the list.
+	///
+	/// A chunk reached through a non-const element access, iterator or segment
+	/// counts as written even if it was only read: a read loop over a non-const
+	/// list makes the next delta resend every chunk. Read through a const view
+	/// of the list instead, e.g. std::as_const(list), cbegin() or the const
+	/// for_each_chunk.
+	/// @tparam List ChunkList keeping a ChunkVersion per chunk, e.g.
+	/// TrackedChunkList
+	template <class List>
+	class DeltaTracker {
+	public:
+		using value_type = typename List::value_type;
+
+		/// @brief Returns the changes of list since the previous delta, or all of
+		/// it on the first call.
+		ChunkListDelta<value_type> delta(List& list) {
+			ChunkListDelta<value_type> result;
+			result.version = ChunkVersion::next_version();
+			result.size = list.size();
+			std::unordered_map<std::uint64_t, std::uint64_t> now_sent;
+			list.for_each_chunk([&](std::span<value_type> elements, ChunkVersion& chunk) {
+				chunk.stamp(result.version);
+				result.order.push_back(chunk.id);
+				auto it = sent.find(chunk.id);
+				if (it == sent.end() || it->second != chunk.version)
+					result.chunks.emplace_back(chunk.id, std::vector<value_type>(elements.begin(), elements.end()));
+				now_sent.emplace(chunk.id, chunk.version);
+			});
+			sent = std::move(now_sent);
+			return result;
+		}
+
+		/// @brief Forgets what was sent, so the next delta holds the whole list,
+		/// e.g. for a replica that starts over.
+		void reset() noexcept { sent.clear(); }
+
+	private:
+		std::unordered_map<std::uint64_t, std::uint64_t> sent;
+	};
+
+	/// @brief Brings replica to the state the delta was taken at. Unchanged
+	/// chunks that moved to another position are copied over from the replica,
+	/// so the cost is the size of the delta unless chunks were relinked.
+	/// @param replica list holding the state of the previous delta applied
+	/// @param delta changes to apply
+	/// @throw std::invalid_argument if the delta was not taken against the
+	/// state of the replica
+	template <class List>
+	void apply_delta(List& replica, const ChunkListDelta<typename List::value_type>& delta) {
+		using value_type = typename List::value_type;
+		std::unordered_map<std::uint64_t, const std::vector<value_type>*> changed;
+		for (const auto& [id, elements] : delta.chunks)
+			changed.emplace(id, &elements);
+
+		std::vector<std::uint64_t> current;
+		std::vector<std::span<value_type>> current_elements;
+		std::unordered_map<std::uint64_t, std::size_t> where;
+		replica.for_each_chunk([&](std::span<value_type> elements, ChunkVersion& chunk) {
+			where.emplace(chunk.id, current.size());
+			current.push_back(chunk.id);
+			current_elements.push_back(elements);
+		});
+
+		// Chunks kept but moved are saved before the replica is resized
+		std::unordered_map<std::uint64_t, std::vector<value_type>> moved;
+		for (std::size_t k = 0; k < delta.order.size(); k++) {
+			std::uint64_t id = delta.order[k];
+			if (changed.contains(id) || (k < current.size() && current[k] == id))
+				continue;
+			auto it = where.find(id);
+			if (it == where.end())
+				throw std::invalid_argument("Delta refers to a chunk the replica does not have");
+			std::span<value_type> elements = current_elements[it->second];
+			moved.emplace(id, std::vector<value_type>(elements.begin(), elements.end()));
+		}
+
+		replica.resize(delta.size);
+		std::size_t k = 0;
+		replica.for_each_chunk([&](std::span<value_type> elements, ChunkVersion& chunk) {
+			if (k == delta.order.size())
+				throw std::invalid_argument("Delta does not match the chunks of the replica");
+			std::uint64_t id = delta.order[k++];
+			const std::vector<value_type>* source = nullptr;
+			if (auto it = changed.find(id); it != changed.end())
+				source = it->second;
+			else if (auto it = moved.find(id); it != moved.end())
+				source = &it->second;
+			if (source != nullptr) {
+				if (source->size() != elements.size())
+					throw std::invalid_argument("Delta does not match the chunks of the replica");
+				std::copy(source->begin(), source->end(), elements.begin());
+				chunk.invalidate();
+			}
+			chunk.id = id;
+		});
+		if (k != delta.order.size())
+			throw std::invalid_argument("Delta does not match the chunks of the replica");
+	}
+
+	/// @brief ChunkList keeping a ChunkVersion per chunk, so DeltaTracker can
+	/// replicate it by the chunks that changed.
+	///
+	/// Reads that should not be replicated must go through a const view:
+	/// non-const at(), operator[], front(), back(), begin() and segments() mark
+	/// the chunks they reach as written, since the references they return may
+	/// be written through.
+	template <typename T, std::size_t N = default_chunk_size<T>(), typename Allocator = Allocator<T>>
+	using TrackedChunkList = ChunkList<T, N, Allocator, FixedChunkSize<N>, 0, ChunkVersion>;
+}  // namespace fefu_laboratory_two
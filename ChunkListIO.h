@@ -0,0 +1,455 @@
+#pragma once
+#include "Chunk.h"
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+
+namespace fefu_laboratory_two {
+	/// @brief Encodes elements of a ChunkList for save() and load().
+	///
+	/// Trivially copyable types are stored as their object representation and
+	/// whole chunk payloads are written as they are in memory. Other types need a
+	/// specialization with raw = false and
+	///
+	///     static void encode(const T& value, std::vector<char>& out);
+	///     static const char* decode(const char* first, const char* last, T& value);
+	///
+	/// encode appends the bytes of value to out. decode reads one value from
+	/// [first, last), returns the position after it and throws
+	/// std::runtime_error if the bytes are malformed.
+	template <typename T>
+	struct ElementCodec {
+		static_assert(std::is_trivially_copyable_v<T>,
+			"Specialize ElementCodec for types that are not trivially copyable");
+
+		static constexpr bool raw = true;
+	};
+
+	/// @brief Stores a string as its length followed by its characters.
+	template <typename CharT, typename Traits, typename Alloc>
+	struct ElementCodec<std::basic_string<CharT, Traits, Alloc>> {
+		using string_type = std::basic_string<CharT, Traits, Alloc>;
+
+		static constexpr bool raw = false;
+
+		static void encode(const string_type& value, std::vector<char>& out) {
+			std::uint64_t length = value.size();
+			const char* bytes = reinterpret_cast<const char*>(&length);
+			out.insert(out.end(), bytes, bytes + sizeof(length));
+			bytes = reinterpret_cast<const char*>(value.data());
+			out.insert(out.end(), bytes, bytes + length * sizeof(CharT));
+		}
+
+		static const char* decode(const char* first, const char* last, string_type& value) {
+			std::uint64_t length;
+			if (static_cast<std::size_t>(last - first) < sizeof(length))
+				throw std::runtime_error("Truncated string length");
+			std::memcpy(&length, first, sizeof(length));
+			first += sizeof(length);
+			if (length > static_cast<std::size_t>(last - first) / sizeof(CharT))
+				throw std::runtime_error("Truncated string");
+			value.resize(static_cast<std::size_t>(length));
+			std::memcpy(value.data(), first, static_cast<std::size_t>(length) * sizeof(CharT));
+			return first + length * sizeof(CharT);
+		}
+	};
+
+	/// @brief Layout of the binary ChunkList format.
+	///
+	/// A file starts with a FileHeader and holds one block per chunk. A block is
+	/// a BlockHeader followed by the encoded elements of the chunk. Headers and
+	/// payloads carry CRC-32 checksums, so a damaged block is reported when it
+	/// is read, without reading the rest of the file. Integers are stored in the
+	/// byte order of the writer; a file from a machine of another byte order
+	/// fails the magic check.
+	namespace chunk_format {
+		/// @brief "CHNKLSTB"
+		constexpr std::uint64_t magic = 0x4254534c4b4e4843ull;
+		constexpr std::uint32_t version = 1;
+
+		/// @brief Set when payloads hold the object representation of the
+		/// elements, clear when they were written by an element codec.
+		constexpr std::uint32_t raw_payload = 1;
+
+		struct FileHeader {
+			std::uint64_t magic;
+			std::uint32_t version;
+			std::uint32_t flags;
+			std::uint64_t value_size;
+			std::uint64_t chunk_size;
+			std::uint64_t count;
+			std::uint32_t reserved;
+			std::uint32_t header_checksum;
+		};
+
+		struct BlockHeader {
+			std::uint64_t count;
+			std::uint64_t bytes;
+			std::uint32_t payload_checksum;
+			std::uint32_t header_checksum;
+		};
+
+		/// @brief CRC-32 (IEEE 802.3) of [data, data + size), continuing from crc.
+		inline std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t crc = 0) noexcept {
+			static constexpr std::array<std::uint32_t, 256> table = [] {
+				std::array<std::uint32_t, 256> result{};
+				for (std::uint32_t i = 0; i < 256; i++) {
+					std::uint32_t c = i;
+					for (int k = 0; k < 8; k++)
+						c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+					result[i] = c;
+				}
+				return result;
+			}();
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			crc = ~crc;
+			for (std::size_t i = 0; i < size; i++)
+				crc = table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+			return ~crc;
+		}
+
+		/// @brief Checksum of a header, computed over the fields before
+		/// header_checksum.
+		template <class Header>
+		std::uint32_t header_checksum(const Header& header) noexcept {
+			return crc32(&header, offsetof(Header, header_checksum));
+		}
+
+		inline void write_all(int fd, const void* data, std::size_t size) {
+			const char* bytes = static_cast<const char*>(data);
+			while (size > 0) {
+#ifdef _WIN32
+				int written = ::_write(fd, bytes, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+#else
+				ssize_t written = ::write(fd, bytes, size);
+#endif
+				if (written < 0) {
+					if (errno == EINTR)
+						continue;
+					throw std::system_error(errno, std::generic_category(), "write");
+				}
+				bytes += written;
+				size -= static_cast<std::size_t>(written);
+			}
+		}
+
+		inline void read_all(int fd, void* data, std::size_t size) {
+			char* bytes = static_cast<char*>(data);
+			while (size > 0) {
+#ifdef _WIN32
+				int got = ::_read(fd, bytes, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+#else
+				ssize_t got = ::read(fd, bytes, size);
+#endif
+				if (got < 0) {
+					if (errno == EINTR)
+						continue;
+					throw std::system_error(errno, std::generic_category(), "read");
+				}
+				if (got == 0)
+					throw std::runtime_error("Unexpected end of ChunkList data");
+				bytes += got;
+				size -= static_cast<std::size_t>(got);
+			}
+		}
+	}  // namespace chunk_format
+
+	/// @brief Writes list to fd in the binary ChunkList format, one block per
+	/// chunk. Chunks of trivially copyable elements are written straight from
+	/// their storage.
+	/// @tparam Codec element codec, see ElementCodec
+	/// @param fd descriptor open for writing, positioned where the data starts
+	/// @param list list to write
+	/// @throw std::system_error if writing fails
+	template <class Codec = void, class List>
+	void save(int fd, const List& list) {
+		using value_type = typename List::value_type;
+		using codec = std::conditional_t<std::is_void_v<Codec>, ElementCodec<value_type>, Codec>;
+		using namespace chunk_format;
+
+		FileHeader header{};
+		header.magic = magic;
+		header.version = version;
+		header.flags = codec::raw ? raw_payload : 0;
+		header.value_size = sizeof(value_type);
+		header.chunk_size = list.get_size_policy().capacity(0);
+		header.count = list.size();
+		header.header_checksum = header_checksum(header);
+		write_all(fd, &header, sizeof(header));
+
+		std::vector<char> buffer;
+		for (auto* chunk = list.front_chunk(); chunk != nullptr; chunk = chunk->next) {
+			if (chunk->num_of_elements == 0)
+				continue;
+			const void* payload;
+			BlockHeader block{};
+			block.count = chunk->num_of_elements;
+			if constexpr (codec::raw) {
+				payload = chunk->list;
+				block.bytes = chunk->num_of_elements * sizeof(value_type);
+			}
+			else {
+				buffer.clear();
+				for (const value_type* el = chunk->begin(); el != chunk->end(); el++)
+					codec::encode(*el, buffer);
+				payload = buffer.data();
+				block.bytes = buffer.size();
+			}
+			block.payload_checksum = crc32(payload, static_cast<std::size_t>(block.bytes));
+			block.header_checksum = header_checksum(block);
+			write_all(fd, &block, sizeof(block));
+			write_all(fd, payload, static_cast<std::size_t>(block.bytes));
+		}
+	}
+
+	/// @brief Reads a list written by save() one block at a time, so a large
+	/// list can be processed without holding all of it in memory.
+	///
+	/// Every block is checked before its elements are handed out. Blocks are
+	/// re-chunked by the receiving list, which may use another chunk size than
+	/// the writer.
+	/// @tparam T type of the elements
+	/// @tparam Codec element codec, must match the one used by save()
+	template <typename T, class Codec = ElementCodec<T>>
+	class ChunkListLoader {
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+
+		/// @brief Reads and checks the file header.
+		/// @param fd descriptor open for reading, positioned at the header
+		/// @throw std::runtime_error if the data is not a ChunkList of T written
+		/// with a compatible codec, or the header is damaged
+		/// @throw std::system_error if reading fails
+		explicit ChunkListLoader(int fd) : fd(fd) {
+			using namespace chunk_format;
+			chunk_format::read_all(fd, &header, sizeof(header));
+			if (header.magic != chunk_format::magic)
+				throw std::runtime_error("Not a ChunkList file");
+			if (header.header_checksum != header_checksum(header))
+				throw std::runtime_error("ChunkList header checksum mismatch");
+			if (header.version > chunk_format::version)
+				throw std::runtime_error("Unsupported ChunkList format version");
+			if (header.value_size != sizeof(T) || ((header.flags & raw_payload) != 0) != Codec::raw)
+				throw std::runtime_error("ChunkList was written for another element type");
+		}
+
+		/// @brief Returns the number of elements in the file.
+		size_type size() const noexcept { return static_cast<size_type>(header.count); }
+
+		/// @brief Returns the number of elements read so far.
+		size_type loaded() const noexcept { return loaded_count; }
+
+		/// @brief Returns the chunk size of the list that was written.
+		size_type chunk_size() const noexcept { return static_cast<size_type>(header.chunk_size); }
+
+		/// @brief Appends the elements of the next block to list. The list is left
+		/// unchanged if the block is damaged.
+		/// @return false if every block has been read.
+		/// @throw std::runtime_error if the block is damaged or the data ends early
+		/// @throw std::system_error if reading fails
+		template <class List>
+		bool load_next_chunk(List& list) {
+			using namespace chunk_format;
+			if (loaded_count == header.count)
+				return false;
+
+			BlockHeader block;
+			read_all(fd, &block, sizeof(block));
+			if (block.header_checksum != header_checksum(block))
+				throw std::runtime_error("Damaged block header at block " + std::to_string(block_index));
+			if (block.count == 0 || block.count > header.count - loaded_count)
+				throw std::runtime_error("Block " + std::to_string(block_index) + " holds more elements than the file");
+			if (Codec::raw && block.bytes != block.count * sizeof(T))
+				throw std::runtime_error("Block " + std::to_string(block_index) + " has the wrong payload size");
+
+			buffer.resize(static_cast<std::size_t>(block.bytes));
+			read_all(fd, buffer.data(), buffer.size());
+			if (block.payload_checksum != crc32(buffer.data(), buffer.size()))
+				throw std::runtime_error("Checksum mismatch in block " + std::to_string(block_index));
+
+			if constexpr (Codec::raw) {
+				for (std::uint64_t i = 0; i < block.count; i++) {
+					T value;
+					std::memcpy(&value, buffer.data() + i * sizeof(T), sizeof(T));
+					list.push_back(value);
+				}
+			}
+			else {
+				// Decodes the whole block first, so a malformed one adds nothing
+				std::vector<T> values(static_cast<std::size_t>(block.count));
+				const char* first = buffer.data();
+				const char* last = first + buffer.size();
+				for (T& value : values)
+					first = Codec::decode(first, last, value);
+				if (first != last)
+					throw std::runtime_error("Block " + std::to_string(block_index) + " has trailing bytes");
+				for (T& value : values)
+					list.push_back(std::move(value));
+			}
+
+			loaded_count += static_cast<size_type>(block.count);
+			block_index++;
+			return true;
+		}
+
+	private:
+		int fd;
+		chunk_format::FileHeader header{};
+		std::vector<char> buffer;
+		size_type loaded_count = 0;
+		size_type block_index = 0;
+	};
+
+	/// @brief Replaces the contents of list with a list written by save().
+	/// @tparam Codec element codec, must match the one used by save()
+	/// @param fd descriptor open for reading, positioned where the data starts
+	/// @param list list to fill
+	/// @throw std::runtime_error if the data is damaged or holds another type;
+	/// list then holds the elements of the blocks read before the damage
+	/// @throw std::system_error if reading fails
+	template <class Codec = void, class List>
+	void load(int fd, List& list) {
+		using value_type = typename List::value_type;
+		using codec = std::conditional_t<std::is_void_v<Codec>, ElementCodec<value_type>, Codec>;
+		ChunkListLoader<value_type, codec> loader(fd);
+		list.clear();
+		while (loader.load_next_chunk(list)) {
+		}
+	}
+
+#ifndef _WIN32
+	/// GATHER AND SCATTER I/O
+
+	namespace chunk_format {
+#ifdef IOV_MAX
+		constexpr int iov_batch = IOV_MAX;
+#else
+		constexpr int iov_batch = 1024;
+#endif
+
+		/// @brief Repeats op until every byte described by iov[0, count) is
+		/// transferred, advancing past partial transfers.
+		/// @param op callable taking (const iovec*, int) and returning the result
+		/// of readv/writev
+		template <class Op>
+		void transfer_iovecs(iovec* iov, int count, Op op, const char* what) {
+			while (count > 0) {
+				ssize_t done = op(iov, count);
+				if (done < 0) {
+					if (errno == EINTR)
+						continue;
+					throw std::system_error(errno, std::generic_category(), what);
+				}
+				if (done == 0)
+					throw std::runtime_error("Unexpected end of ChunkList data");
+				std::size_t left = static_cast<std::size_t>(done);
+				while (count > 0 && left >= iov->iov_len) {
+					left -= iov->iov_len;
+					iov++;
+					count--;
+				}
+				if (count > 0) {
+					iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+					iov->iov_len -= left;
+				}
+			}
+		}
+	}  // namespace chunk_format
+
+	/// @brief Calls f with arrays of iovec pointing at the live elements of list
+	/// from position first on, one entry per chunk and at most IOV_MAX entries
+	/// per call. Nothing is copied: the entries address chunk storage, so they
+	/// are valid until the list is modified.
+	/// @param list list whose elements to describe
+	/// @param f callable taking (iovec*, int)
+	/// @param first position of the first element to describe
+	template <class List, class F>
+	void for_each_iovec_batch(List& list, F f, std::size_t first = 0) {
+		using value_type = typename List::value_type;
+		std::vector<iovec> batch;
+		batch.reserve(std::min<std::size_t>(list.chunk_count(), chunk_format::iov_batch));
+		std::size_t skip = first;
+		for (auto* chunk = list.front_chunk(); chunk != nullptr; chunk = chunk->next) {
+			if (skip >= chunk->num_of_elements) {
+				skip -= chunk->num_of_elements;
+				continue;
+			}
+			iovec entry;
+			entry.iov_base = const_cast<std::remove_const_t<value_type>*>(chunk->list + skip);
+			entry.iov_len = (chunk->num_of_elements - skip) * sizeof(value_type);
+			skip = 0;
+			batch.push_back(entry);
+			if (batch.size() == static_cast<std::size_t>(chunk_format::iov_batch)) {
+				f(batch.data(), static_cast<int>(batch.size()));
+				batch.clear();
+			}
+		}
+		if (!batch.empty())
+			f(batch.data(), static_cast<int>(batch.size()));
+	}
+
+	/// @brief Writes the elements of list to fd with writev, straight from chunk
+	/// storage. Only the payload is written, without the header of save().
+	/// @throw std::system_error if writing fails
+	template <class List>
+	void gather_write(int fd, const List& list) {
+		static_assert(std::is_trivially_copyable_v<typename List::value_type>,
+			"Gather I/O needs trivially copyable elements");
+		for_each_iovec_batch(list, [fd](iovec* iov, int count) {
+			chunk_format::transfer_iovecs(iov, count, [fd](const iovec* v, int n) {
+				return ::writev(fd, v, n);
+				}, "writev");
+			});
+	}
+
+	/// @brief Writes the elements of list to fd at offset with pwritev, straight
+	/// from chunk storage. The file position is not changed.
+	/// @throw std::system_error if writing fails
+	template <class List>
+	void gather_pwrite(int fd, const List& list, off_t offset) {
+		static_assert(std::is_trivially_copyable_v<typename List::value_type>,
+			"Gather I/O needs trivially copyable elements");
+		for_each_iovec_batch(list, [fd, &offset](iovec* iov, int count) {
+			chunk_format::transfer_iovecs(iov, count, [fd, &offset](const iovec* v, int n) {
+				ssize_t done = ::pwritev(fd, v, n, offset);
+				if (done > 0)
+					offset += done;
+				return done;
+				}, "pwritev");
+			});
+	}
+
+	/// @brief Fills the elements of list from position first on with readv,
+	/// straight into chunk storage. Chunks are pre-allocated by the caller, e.g.
+	/// with extend(). Chunk summaries of the list are invalidated.
+	/// @throw std::runtime_error if fd ends before the elements are filled
+	/// @throw std::system_error if reading fails
+	template <class List>
+	void scatter_read(int fd, List& list, std::size_t first = 0) {
+		static_assert(std::is_trivially_copyable_v<typename List::value_type>,
+			"Scatter I/O needs trivially copyable elements");
+		if constexpr (requires { list.invalidate_summaries(); })
+			list.invalidate_summaries();
+		for_each_iovec_batch(list, [fd](iovec* iov, int count) {
+			chunk_format::transfer_iovecs(iov, count, [fd](const iovec* v, int n) {
+				return ::readv(fd, v, n);
+				}, "readv");
+			}, first);
+	}
+#endif
+}  // namespace fefu_laboratory_two
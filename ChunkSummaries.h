@@ -0,0 +1,180 @@
+#pragma once
+#include "Chunk.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+
+
+namespace fefu_laboratory_two {
+	/// @brief Chunk summary keeping the smallest and the largest element of a
+	/// chunk and, optionally, a Bloom filter of its elements.
+	///
+	/// Removing an element leaves the bounds and the filter bits as they are,
+	/// so they describe a superset of the elements: a query may read a chunk it
+	/// could have skipped, but never skips one it has to read. Both are exact
+	/// again after the chunk is rebuilt.
+	/// @tparam T type of the elements, ordered by operator< and hashed with
+	/// std::hash when BloomBits is not 0
+	/// @tparam BloomBits size of the Bloom filter, 0 for none
+	template <typename T, std::size_t BloomBits = 0>
+	struct ZoneMap {
+		static constexpr bool enabled = true;
+		static constexpr std::size_t bloom_words = (BloomBits + 63) / 64;
+
+		T min_value{};
+		T max_value{};
+		bool has_values = false;
+		bool is_stale = false;
+		std::array<std::uint64_t, bloom_words> bloom{};
+
+		void add(const T& value) {
+			if (!has_values) {
+				min_value = value;
+				max_value = value;
+				has_values = true;
+			}
+			else if (value < min_value) {
+				min_value = value;
+			}
+			else if (max_value < value) {
+				max_value = value;
+			}
+			if constexpr (BloomBits > 0) {
+				std::uint64_t h = hash(value);
+				set_bit(h);
+				set_bit(h >> 32);
+			}
+		}
+
+		void remove(const T&) noexcept {}
+
+		void invalidate() noexcept { is_stale = true; }
+
+		bool stale() const noexcept { return is_stale; }
+
+		void rebuild(const T* first, const T* last) {
+			*this = ZoneMap();
+			for (; first != last; first++)
+				add(*first);
+		}
+
+		/// @brief Checks if the chunk may hold elements in the closed range
+		/// [lo, hi].
+		bool may_overlap(const T& lo, const T& hi) const {
+			return has_values && !(hi < min_value) && !(max_value < lo);
+		}
+
+		/// @brief Checks if every element of the chunk is in the closed range
+		/// [lo, hi].
+		bool all_within(const T& lo, const T& hi) const {
+			return has_values && !(min_value < lo) && !(hi < max_value);
+		}
+
+		/// @brief Checks if the chunk may hold an element equal to value.
+		bool may_contain(const T& value) const {
+			if constexpr (BloomBits > 0) {
+				std::uint64_t h = hash(value);
+				return test_bit(h) && test_bit(h >> 32);
+			}
+			else {
+				return may_overlap(value, value);
+			}
+		}
+
+	private:
+		/// @brief Spreads std::hash, which is the identity for integers on common
+		/// implementations, over all 64 bits (the splitmix64 finalizer).
+		static std::uint64_t hash(const T& value) {
+			std::uint64_t h = static_cast<std::uint64_t>(std::hash<T>()(value));
+			h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+			h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+			return h ^ (h >> 31);
+		}
+
+		void set_bit(std::uint64_t h) noexcept {
+			std::size_t bit = static_cast<std::size_t>((h & 0xffffffff) % BloomBits);
+			bloom[bit / 64] |= std::uint64_t(1) << (bit % 64);
+		}
+
+		bool test_bit(std::uint64_t h) const noexcept {
+			std::size_t bit = static_cast<std::size_t>((h & 0xffffffff) % BloomBits);
+			return (bloom[bit / 64] >> (bit % 64)) & 1;
+		}
+	};
+
+	/// @brief Chunk summary caching the sum, the minimum and the maximum of the
+	/// elements of a chunk.
+	///
+	/// Unlike ZoneMap the values are exact: removing an element subtracts it
+	/// from the sum, and removing the minimum or the maximum makes the summary
+	/// stale, so it is rebuilt on the next query. The bounds also let the range
+	/// filters skip chunks.
+	/// @tparam T arithmetic type of the elements
+	template <typename T>
+	struct ChunkAggregates {
+		static constexpr bool enabled = true;
+
+		T total{};
+		T min_value{};
+		T max_value{};
+		bool has_values = false;
+		bool is_stale = false;
+
+		void add(const T& value) {
+			total += value;
+			if (!has_values) {
+				min_value = value;
+				max_value = value;
+				has_values = true;
+			}
+			else if (value < min_value) {
+				min_value = value;
+			}
+			else if (max_value < value) {
+				max_value = value;
+			}
+		}
+
+		void remove(const T& value) {
+			total -= value;
+			if (!(min_value < value) || !(value < max_value))
+				is_stale = true;
+		}
+
+		void invalidate() noexcept { is_stale = true; }
+
+		bool stale() const noexcept { return is_stale; }
+
+		void rebuild(const T* first, const T* last) {
+			*this = ChunkAggregates();
+			for (; first != last; first++)
+				add(*first);
+		}
+
+		T sum() const { return total; }
+		T min() const { return min_value; }
+		T max() const { return max_value; }
+
+		bool may_overlap(const T& lo, const T& hi) const {
+			return has_values && !(hi < min_value) && !(max_value < lo);
+		}
+
+		bool all_within(const T& lo, const T& hi) const {
+			return has_values && !(min_value < lo) && !(hi < max_value);
+		}
+	};
+
+	/// @brief ChunkList keeping a ZoneMap per chunk, so count_in_range,
+	/// filter_range, find_in_range and find_value skip the chunks that cannot
+	/// match. Pays off when neighbouring elements have close values, e.g.
+	/// timestamps or sorted runs.
+	template <typename T, std::size_t N = default_chunk_size<T>(), std::size_t BloomBits = 0,
+		typename Allocator = Allocator<T>>
+	using ZoneMappedChunkList = ChunkList<T, N, Allocator, FixedChunkSize<N>, 0, ZoneMap<T, BloomBits>>;
+
+	/// @brief ChunkList caching ChunkAggregates per chunk, so range_sum,
+	/// range_min and range_max read the elements of at most two chunks and one
+	/// cached value for every chunk in between.
+	template <typename T, std::size_t N = default_chunk_size<T>(), typename Allocator = Allocator<T>>
+	using AggregatedChunkList = ChunkList<T, N, Allocator, FixedChunkSize<N>, 0, ChunkAggregates<T>>;
+}  // namespace fefu_laboratory_two
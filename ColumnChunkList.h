@@ -0,0 +1,266 @@
+#pragma once
+#include "Chunk.h"
+#include <array>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace fefu_laboratory_two {
+	/// @brief ChunkList storing a struct column by column.
+	///
+	/// Each chunk holds one contiguous array per listed field, so a scan over one
+	/// field reads only that field's cache lines. Elements are accessed by
+	/// position as in ChunkList: reads return a T assembled from the columns,
+	/// writes go through a proxy reference, and column() exposes the arrays of a
+	/// chunk as spans for vectorized scans.
+	///
+	/// Fields that are not listed are not stored and read back
+	/// value-initialized.
+	/// @tparam T default constructible struct
+	/// @tparam N capacity of a chunk
+	/// @tparam Fields pointers to the data members of T to store, e.g.
+	/// &Tick::timestamp, &Tick::value
+	template <typename T, std::size_t N, auto... Fields>
+	class ColumnChunkList {
+		static_assert(sizeof...(Fields) > 0, "A columnar list needs at least one field");
+		static_assert((std::is_member_object_pointer_v<decltype(Fields)> && ...), "Fields must point to data members");
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using const_reference = value_type;
+
+		/// @brief Type of the data member Member points to.
+		template <auto Member>
+		using field_type = std::remove_cvref_t<decltype(std::declval<T&>().*Member)>;
+
+		/// @brief Proxy standing for an element. Converts to T, and assignment
+		/// scatters a T over the columns.
+		class reference {
+		public:
+			operator T() const {
+				return list->gather(chunk_index, offset, indices());
+			}
+
+			reference& operator=(const T& value) {
+				list->scatter(chunk_index, offset, value, indices());
+				return *this;
+			}
+
+			reference& operator=(const reference& other) {
+				return *this = static_cast<T>(other);
+			}
+
+			/// @brief Returns the field Member of the element.
+			template <auto Member>
+			field_type<Member>& get() const {
+				return list->template column_array<Member>(chunk_index)[offset];
+			}
+
+		private:
+			friend class ColumnChunkList;
+
+			reference(ColumnChunkList* list, size_type chunk_index, size_type offset)
+				: list(list), chunk_index(chunk_index), offset(offset) {}
+
+			ColumnChunkList* list;
+			size_type chunk_index;
+			size_type offset;
+		};
+
+		ColumnChunkList() {};
+
+		ColumnChunkList(std::initializer_list<T> init) {
+			for (const T& value : init)
+				push_back(value);
+		};
+
+		ColumnChunkList(const ColumnChunkList& other) {
+			for (const auto& chunk : other.chunks)
+				chunks.push_back(std::make_unique<chunk_storage>(*chunk));
+			list_size = other.list_size;
+		};
+
+		ColumnChunkList(ColumnChunkList&& other) noexcept {
+			std::swap(chunks, other.chunks);
+			std::swap(list_size, other.list_size);
+		};
+
+		ColumnChunkList& operator=(ColumnChunkList other) noexcept {
+			std::swap(chunks, other.chunks);
+			std::swap(list_size, other.list_size);
+			return *this;
+		};
+
+		/// ELEMENT ACCESS
+
+		/// @throw std::out_of_range
+		reference at(size_type pos) {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @throw std::out_of_range
+		const_reference at(size_type pos) const {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @brief Returns a proxy for the element at pos. No bounds checking is
+		/// performed.
+		reference operator[](size_type pos) {
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			return reference(this, chunk_index, offset);
+		};
+
+		/// @brief Returns the element at pos assembled from the columns. No bounds
+		/// checking is performed.
+		const_reference operator[](size_type pos) const {
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			return gather(chunk_index, offset, indices());
+		};
+
+		reference front() { return at(0); };
+		const_reference front() const { return at(0); };
+		reference back() { return at(size() - 1); };
+		const_reference back() const { return at(size() - 1); };
+
+		/// @brief Returns the field Member of the element at pos. No bounds
+		/// checking is performed.
+		template <auto Member>
+		field_type<Member>& get(size_type pos) {
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			return column_array<Member>(chunk_index)[offset];
+		};
+
+		template <auto Member>
+		const field_type<Member>& get(size_type pos) const {
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			return column_array<Member>(chunk_index)[offset];
+		};
+
+		/// @brief Returns the live values of field Member in chunk chunk_index.
+		template <auto Member>
+		std::span<field_type<Member>> column(size_type chunk_index) {
+			return { column_array<Member>(chunk_index).data(), chunk_length(chunk_index) };
+		};
+
+		template <auto Member>
+		std::span<const field_type<Member>> column(size_type chunk_index) const {
+			return { column_array<Member>(chunk_index).data(), chunk_length(chunk_index) };
+		};
+
+		/// @brief Calls f with the span of field Member of every chunk in order.
+		template <auto Member, class F>
+		void for_each_column(F f) const {
+			for (size_type i = 0; i < chunks.size(); i++)
+				f(column<Member>(i));
+		};
+
+		/// @brief Calls f with every element in order.
+		template <class F>
+		void for_each(F f) const {
+			for (size_type i = 0; i < chunks.size(); i++)
+				for (size_type j = 0; j < chunk_length(i); j++)
+					f(gather(i, j, indices()));
+		};
+
+		/// CAPACITY
+
+		bool empty() const noexcept { return list_size == 0; };
+
+		size_type size() const noexcept { return list_size; };
+
+		size_type chunk_count() const noexcept { return chunks.size(); };
+
+		/// MODIFIERS
+
+		void push_back(const T& value) {
+			if (list_size == chunks.size() * N)
+				chunks.push_back(std::make_unique<chunk_storage>());
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(list_size, chunk_index, offset);
+			scatter(chunk_index, offset, value, indices());
+			list_size++;
+		};
+
+		void pop_back() {
+			if (list_size == 0)
+				return;
+			list_size--;
+			if (list_size == (chunks.size() - 1) * N)
+				chunks.pop_back();
+		};
+
+		void clear() noexcept {
+			chunks.clear();
+			list_size = 0;
+		};
+
+		void swap(ColumnChunkList& other) noexcept {
+			std::swap(chunks, other.chunks);
+			std::swap(list_size, other.list_size);
+		};
+
+	private:
+		using indices = std::index_sequence_for<decltype(Fields)...>;
+
+		/// @brief One array per field.
+		using chunk_storage = std::tuple<std::array<field_type<Fields>, N>...>;
+
+		/// @brief Position of Member in Fields.
+		template <auto Member>
+		static constexpr std::size_t column_index() {
+			constexpr bool matches[] = { same_member<Member, Fields>()... };
+			for (std::size_t i = 0; i < sizeof...(Fields); i++)
+				if (matches[i])
+					return i;
+			return sizeof...(Fields);
+		}
+
+		template <auto A, auto B>
+		static constexpr bool same_member() {
+			if constexpr (std::is_same_v<decltype(A), decltype(B)>)
+				return A == B;
+			else
+				return false;
+		}
+
+		template <auto Member>
+		auto& column_array(size_type chunk_index) const {
+			constexpr std::size_t index = column_index<Member>();
+			static_assert(index < sizeof...(Fields), "Member is not a column of this list");
+			return std::get<index>(*chunks[chunk_index]);
+		}
+
+		size_type chunk_length(size_type chunk_index) const noexcept {
+			return chunk_index + 1 < chunks.size() ? N : list_size - chunk_index * N;
+		}
+
+		template <std::size_t... Is>
+		T gather(size_type chunk_index, size_type offset, std::index_sequence<Is...>) const {
+			T value{};
+			const chunk_storage& chunk = *chunks[chunk_index];
+			((value.*Fields = std::get<Is>(chunk)[offset]), ...);
+			return value;
+		}
+
+		template <std::size_t... Is>
+		void scatter(size_type chunk_index, size_type offset, const T& value, std::index_sequence<Is...>) {
+			chunk_storage& chunk = *chunks[chunk_index];
+			((std::get<Is>(chunk)[offset] = value.*Fields), ...);
+		}
+
+		std::vector<std::unique_ptr<chunk_storage>> chunks;
+		size_type list_size = 0;
+	};
+}  // namespace fefu_laboratory_two
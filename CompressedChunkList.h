@@ -0,0 +1,322 @@
+#pragma once
+#include "Chunk.h"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+
+namespace fefu_laboratory_two {
+	/// @brief Memory held by a CompressedChunkList.
+	struct CompressionStats {
+		std::size_t chunks = 0;
+		std::size_t delta_varint_chunks = 0;
+		std::size_t bit_packed_chunks = 0;
+		/// @brief Bytes the elements would take uncompressed.
+		std::size_t raw_bytes = 0;
+		/// @brief Bytes actually held by chunk payloads.
+		std::size_t stored_bytes = 0;
+
+		std::size_t saved_bytes() const noexcept {
+			return raw_bytes > stored_bytes ? raw_bytes - stored_bytes : 0;
+		}
+	};
+
+	/// @brief ChunkList of integers that compresses sealed chunks.
+	///
+	/// A chunk is sealed when it becomes full. It is then stored with whichever
+	/// is smaller of two encodings, or kept as is if neither saves memory:
+	///  - delta + zig-zag + varint, for slowly varying series;
+	///  - frame of reference: the chunk minimum plus every offset from it
+	///    bit-packed to the width of the largest one, for values in a narrow
+	///    band. Single elements are extracted without decoding the chunk.
+	///
+	/// Reads decompress transparently. A varint chunk is decoded into a one chunk
+	/// cache, so reading it in order costs one decode. Elements are values
+	/// rather than objects, so they are changed with set(), which unseals the
+	/// chunk; compress_sealed() compresses such chunks again.
+	/// @tparam T integral type of the elements
+	/// @tparam N capacity of a chunk
+	template <typename T, std::size_t N = default_chunk_size<T>()>
+	class CompressedChunkList {
+		static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= sizeof(std::uint64_t),
+			"Only integers of up to 64 bits are compressed");
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+
+		CompressedChunkList() {};
+
+		/// ELEMENT ACCESS
+
+		/// @throw std::out_of_range
+		value_type at(size_type pos) const {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @brief Returns the element at pos, decoding its chunk if needed. No
+		/// bounds checking is performed.
+		value_type operator[](size_type pos) const {
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			const chunk_record& chunk = chunks[chunk_index];
+			switch (chunk.kind) {
+			case encoding::bit_packed:
+				return unpack(chunk, offset);
+			case encoding::delta_varint:
+				return decoded(chunk_index)[offset];
+			default:
+				return chunk.raw[offset];
+			}
+		};
+
+		value_type front() const { return at(0); };
+
+		value_type back() const { return at(size() - 1); };
+
+		/// @brief Replaces the element at pos. A compressed chunk is stored
+		/// uncompressed from then on, until compress_sealed() is called.
+		/// @throw std::out_of_range
+		void set(size_type pos, const T& value) {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			inflate(chunk_index);
+			chunks[chunk_index].raw[offset] = value;
+		};
+
+		/// @brief Calls f for every element in order, decoding a chunk at a time.
+		template <class F>
+		void for_each(F f) const {
+			std::vector<T> buffer;
+			for (const chunk_record& chunk : chunks) {
+				if (chunk.kind == encoding::none) {
+					for (const T& value : chunk.raw)
+						f(value);
+					continue;
+				}
+				decode(chunk, buffer);
+				for (const T& value : buffer)
+					f(value);
+			}
+		};
+
+		/// CAPACITY
+
+		bool empty() const noexcept { return list_size == 0; };
+
+		size_type size() const noexcept { return list_size; };
+
+		size_type chunk_count() const noexcept { return chunks.size(); };
+
+		/// @brief Returns how much memory the chunk payloads take compared with
+		/// an uncompressed list.
+		CompressionStats stats() const noexcept {
+			CompressionStats result;
+			result.chunks = chunks.size();
+			result.raw_bytes = list_size * sizeof(T);
+			for (const chunk_record& chunk : chunks) {
+				result.stored_bytes += chunk.raw.capacity() * sizeof(T)
+					+ chunk.bytes.capacity() + chunk.words.capacity() * sizeof(std::uint64_t);
+				if (chunk.kind == encoding::delta_varint)
+					result.delta_varint_chunks++;
+				else if (chunk.kind == encoding::bit_packed)
+					result.bit_packed_chunks++;
+			}
+			return result;
+		};
+
+		/// MODIFIERS
+
+		/// @brief Appends value. The tail chunk is compressed once it is full.
+		void push_back(const T& value) {
+			if (chunks.empty() || chunks.back().count == N) {
+				chunks.emplace_back();
+				chunks.back().raw.reserve(N);
+			}
+			chunk_record& tail = chunks.back();
+			tail.raw.push_back(value);
+			tail.count++;
+			list_size++;
+			if (tail.count == N)
+				seal(chunks.size() - 1);
+		};
+
+		void pop_back() {
+			if (list_size == 0)
+				return;
+			inflate(chunks.size() - 1);
+			chunk_record& tail = chunks.back();
+			tail.raw.pop_back();
+			tail.count--;
+			list_size--;
+			if (tail.count == 0)
+				chunks.pop_back();
+		};
+
+		void clear() noexcept {
+			chunks.clear();
+			list_size = 0;
+			cached_chunk = npos;
+		};
+
+		/// @brief Compresses the full chunks that were unsealed by set() or
+		/// pop_back().
+		void compress_sealed() {
+			for (size_type i = 0; i < chunks.size(); i++)
+				if (chunks[i].count == N && chunks[i].kind == encoding::none && !chunks[i].incompressible)
+					seal(i);
+		};
+
+	private:
+		static constexpr size_type npos = static_cast<size_type>(-1);
+
+		enum class encoding : std::uint8_t { none, delta_varint, bit_packed };
+
+		struct chunk_record {
+			/// @brief Elements of a chunk that is not compressed.
+			std::vector<T> raw;
+			/// @brief Varints of the zig-zag encoded deltas after base.
+			std::vector<std::uint8_t> bytes;
+			/// @brief Offsets from base, width bits each.
+			std::vector<std::uint64_t> words;
+			size_type count = 0;
+			/// @brief First element for delta_varint, minimum for bit_packed.
+			T base = T();
+			std::uint8_t width = 0;
+			encoding kind = encoding::none;
+			/// @brief Set when neither encoding saved memory on the current contents.
+			bool incompressible = false;
+		};
+
+		static std::uint64_t zigzag(std::uint64_t delta) noexcept {
+			return (delta << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(delta) >> 63);
+		}
+
+		static std::uint64_t unzigzag(std::uint64_t value) noexcept {
+			return (value >> 1) ^ (~(value & 1) + 1);
+		}
+
+		/// @brief Stores a full chunk with the smaller encoding.
+		void seal(size_type chunk_index) {
+			chunk_record& chunk = chunks[chunk_index];
+			const std::vector<T>& values = chunk.raw;
+
+			std::vector<std::uint8_t> bytes;
+			bytes.reserve(values.size());
+			for (size_type i = 1; i < values.size(); i++) {
+				std::uint64_t delta = static_cast<std::uint64_t>(values[i]) - static_cast<std::uint64_t>(values[i - 1]);
+				for (std::uint64_t z = zigzag(delta); ; z >>= 7) {
+					if (z < 0x80) {
+						bytes.push_back(static_cast<std::uint8_t>(z));
+						break;
+					}
+					bytes.push_back(static_cast<std::uint8_t>(z | 0x80));
+				}
+			}
+
+			T min_value = *std::min_element(values.begin(), values.end());
+			T max_value = *std::max_element(values.begin(), values.end());
+			std::uint64_t range = static_cast<std::uint64_t>(max_value) - static_cast<std::uint64_t>(min_value);
+			unsigned width = static_cast<unsigned>(std::bit_width(range));
+			size_type packed_bytes = (values.size() * width + 63) / 64 * sizeof(std::uint64_t);
+
+			size_type raw_bytes = values.size() * sizeof(T);
+			if (std::min(bytes.size(), packed_bytes) >= raw_bytes) {
+				chunk.incompressible = true;
+				return;
+			}
+
+			if (packed_bytes <= bytes.size()) {
+				chunk.words.assign((values.size() * width + 63) / 64, 0);
+				for (size_type i = 0; i < values.size() && width > 0; i++) {
+					std::uint64_t offset = static_cast<std::uint64_t>(values[i]) - static_cast<std::uint64_t>(min_value);
+					size_type bit = i * width;
+					chunk.words[bit / 64] |= offset << (bit % 64);
+					if (bit % 64 + width > 64)
+						chunk.words[bit / 64 + 1] |= offset >> (64 - bit % 64);
+				}
+				chunk.base = min_value;
+				chunk.width = static_cast<std::uint8_t>(width);
+				chunk.kind = encoding::bit_packed;
+			}
+			else {
+				bytes.shrink_to_fit();
+				chunk.bytes = std::move(bytes);
+				chunk.base = values.front();
+				chunk.kind = encoding::delta_varint;
+			}
+			chunk.raw = std::vector<T>();
+			if (cached_chunk == chunk_index)
+				cached_chunk = npos;
+		}
+
+		/// @brief Stores a compressed chunk uncompressed again.
+		void inflate(size_type chunk_index) {
+			chunk_record& chunk = chunks[chunk_index];
+			chunk.incompressible = false;
+			if (chunk.kind == encoding::none)
+				return;
+			decode(chunk, chunk.raw);
+			chunk.bytes = std::vector<std::uint8_t>();
+			chunk.words = std::vector<std::uint64_t>();
+			chunk.kind = encoding::none;
+			if (cached_chunk == chunk_index)
+				cached_chunk = npos;
+		}
+
+		static T unpack(const chunk_record& chunk, size_type offset) noexcept {
+			if (chunk.width == 0)
+				return chunk.base;
+			size_type bit = offset * chunk.width;
+			std::uint64_t value = chunk.words[bit / 64] >> (bit % 64);
+			if (bit % 64 + chunk.width > 64)
+				value |= chunk.words[bit / 64 + 1] << (64 - bit % 64);
+			if (chunk.width < 64)
+				value &= (std::uint64_t(1) << chunk.width) - 1;
+			return static_cast<T>(static_cast<std::uint64_t>(chunk.base) + value);
+		}
+
+		static void decode(const chunk_record& chunk, std::vector<T>& out) {
+			out.resize(chunk.count);
+			if (chunk.kind == encoding::bit_packed) {
+				for (size_type i = 0; i < chunk.count; i++)
+					out[i] = unpack(chunk, i);
+				return;
+			}
+			std::uint64_t value = static_cast<std::uint64_t>(chunk.base);
+			out[0] = chunk.base;
+			const std::uint8_t* in = chunk.bytes.data();
+			for (size_type i = 1; i < chunk.count; i++) {
+				std::uint64_t z = 0;
+				for (unsigned shift = 0; ; shift += 7) {
+					std::uint8_t byte = *in++;
+					z |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+					if (byte < 0x80)
+						break;
+				}
+				value += unzigzag(z);
+				out[i] = static_cast<T>(value);
+			}
+		}
+
+		/// @brief Returns the decoded elements of a varint chunk, decoding it into
+		/// the cache unless it is already there.
+		const std::vector<T>& decoded(size_type chunk_index) const {
+			if (cached_chunk != chunk_index) {
+				decode(chunks[chunk_index], cache);
+				cached_chunk = chunk_index;
+			}
+			return cache;
+		}
+
+		std::vector<chunk_record> chunks;
+		size_type list_size = 0;
+		mutable std::vector<T> cache;
+		mutable size_type cached_chunk = npos;
+	};
+}  // namespace fefu_laboratory_two
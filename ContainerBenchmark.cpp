@@ -0,0 +1,292 @@
+// ContainerBenchmark.cpp: ChunkList against std::vector, std::deque and
+// std::list, sweeping the chunk size and the element size. Prints one CSV row
+// per measurement so runs can be diffed and tracked for regressions:
+//
+//   container,chunk_size,element_bytes,benchmark,elements,value,unit
+//
+// chunk_size is 0 for the std containers. Times are the best of a few runs.
+//
+// Build: g++ -std=c++20 -O2 -I. ContainerBenchmark.cpp -o container_bench
+// Usage: container_bench [elements]
+
+#include "Chunk.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace fefu_laboratory_two;
+
+namespace {
+	/// @brief Bytes currently allocated through CountingAllocator.
+	std::size_t allocated_bytes = 0;
+
+	/// @brief Allocator counting the bytes it hands out, for the footprint of
+	/// every container.
+	template <typename T>
+	class CountingAllocator {
+	public:
+		using value_type = T;
+
+		CountingAllocator() = default;
+
+		template <class U>
+		CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+		T* allocate(std::size_t n) {
+			allocated_bytes += n * sizeof(T);
+			return std::allocator<T>().allocate(n);
+		}
+
+		void deallocate(T* p, std::size_t n) noexcept {
+			allocated_bytes -= n * sizeof(T);
+			std::allocator<T>().deallocate(p, n);
+		}
+
+		friend bool operator==(const CountingAllocator&, const CountingAllocator&) noexcept { return true; }
+	};
+
+	/// @brief Element of Bytes bytes, ordered by its first word.
+	template <std::size_t Bytes>
+	struct Element {
+		static_assert(Bytes % sizeof(std::uint32_t) == 0);
+		std::array<std::uint32_t, Bytes / sizeof(std::uint32_t)> words{};
+
+		Element() = default;
+
+		explicit Element(std::uint32_t key) noexcept { words[0] = key; }
+
+		std::uint32_t key() const noexcept { return words[0]; }
+
+		friend bool operator<(const Element& lhs, const Element& rhs) noexcept { return lhs.key() < rhs.key(); }
+	};
+
+	using Clock = std::chrono::steady_clock;
+
+	constexpr int runs = 3;
+
+	/// @brief Returns the best time in nanoseconds of runs calls of measure,
+	/// which times its own work and returns the nanoseconds taken.
+	template <class Measure>
+	double best_ns(Measure measure) {
+		double best = 0;
+		for (int r = 0; r < runs; r++) {
+			double ns = measure();
+			if (r == 0 || ns < best)
+				best = ns;
+		}
+		return best;
+	}
+
+	template <class Work>
+	double time_ns(Work work) {
+		auto start = Clock::now();
+		work();
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+	}
+
+	/// @brief Keeps the compiler from dropping the work that produced value.
+	std::uint64_t sink = 0;
+
+	template <class C>
+	struct Traits {
+		static constexpr bool random_access = true;
+		static constexpr std::size_t chunk_size = 0;
+		static std::size_t overhead(const C&) { return 0; }
+	};
+
+	template <typename T, typename A>
+	struct Traits<std::list<T, A>> {
+		static constexpr bool random_access = false;
+		static constexpr std::size_t chunk_size = 0;
+		static std::size_t overhead(const std::list<T, A>&) { return 0; }
+	};
+
+	template <typename T, std::size_t N, typename A>
+	struct Traits<ChunkList<T, N, A>> {
+		static constexpr bool random_access = true;
+		static constexpr std::size_t chunk_size = N;
+		/// @brief Chunk headers are not allocated through the allocator.
+		static std::size_t overhead(const ChunkList<T, N, A>& list) {
+			return list.chunk_count() * sizeof(Chunk<T, A>);
+		}
+	};
+
+	class Report {
+	public:
+		Report(const char* container, std::size_t chunk_size, std::size_t element_bytes)
+			: container(container), chunk_size(chunk_size), element_bytes(element_bytes) {}
+
+		void operator()(const char* benchmark, std::size_t elements, double value, const char* unit) const {
+			std::printf("%s,%zu,%zu,%s,%zu,%.3f,%s\n", container, chunk_size, element_bytes, benchmark, elements, value, unit);
+		}
+
+	private:
+		const char* container;
+		std::size_t chunk_size;
+		std::size_t element_bytes;
+	};
+
+	template <class C>
+	C make(std::size_t count) {
+		C c;
+		for (std::size_t i = 0; i < count; i++)
+			c.push_back(typename C::value_type(static_cast<std::uint32_t>(i * 2654435761u)));
+		return c;
+	}
+
+	template <class C>
+	void run(const char* name, std::size_t elements) {
+		using T = typename C::value_type;
+		const Report report(name, Traits<C>::chunk_size, sizeof(T));
+		const std::size_t front_elements = std::max<std::size_t>(elements / 32, 1);
+		const std::size_t middle_ops = 1000;
+		const std::size_t lookups = 10000;
+
+		double ns = best_ns([&] {
+			C c;
+			return time_ns([&] {
+				for (std::size_t i = 0; i < elements; i++)
+					c.push_back(T(static_cast<std::uint32_t>(i)));
+			});
+		});
+		report("push_back", elements, ns / elements, "ns/op");
+
+		if constexpr (requires (C& c) { c.push_front(T()); }) {
+			ns = best_ns([&] {
+				C c;
+				return time_ns([&] {
+					for (std::size_t i = 0; i < front_elements; i++)
+						c.push_front(T(static_cast<std::uint32_t>(i)));
+				});
+			});
+			report("push_front", front_elements, ns / front_elements, "ns/op");
+		}
+
+		C filled = make<C>(elements);
+
+		if constexpr (Traits<C>::random_access) {
+			std::mt19937 rng(42);
+			std::vector<std::size_t> positions(lookups);
+			for (auto& pos : positions)
+				pos = rng() % elements;
+			ns = best_ns([&] {
+				return time_ns([&] {
+					for (std::size_t pos : positions)
+						sink += filled.at(pos).key();
+				});
+			});
+			report("random_at", lookups, ns / lookups, "ns/op");
+		}
+
+		ns = best_ns([&] {
+			return time_ns([&] {
+				std::uint64_t sum = 0;
+				for (const T& el : filled)
+					sum += el.key();
+				sink += sum;
+			});
+		});
+		report("iterate", elements, ns / elements, "ns/op");
+
+		if constexpr (segmented_range<C>) {
+			ns = best_ns([&] {
+				return time_ns([&] {
+					std::uint64_t sum = 0;
+					for_each_segmented(std::as_const(filled), [&sum](const T& el) { sum += el.key(); });
+					sink += sum;
+				});
+			});
+			report("iterate_segments", elements, ns / elements, "ns/op");
+		}
+
+		ns = best_ns([&] {
+			C c = filled;
+			auto middle = std::next(c.begin(), static_cast<std::ptrdiff_t>(elements / 2));
+			return time_ns([&] {
+				for (std::size_t i = 0; i < middle_ops; i++) {
+					if constexpr (Traits<C>::random_access)
+						c.insert(c.begin() + static_cast<std::ptrdiff_t>(c.size() / 2), T(1));
+					else
+						c.insert(middle, T(1));
+				}
+			});
+		});
+		report("insert_middle", middle_ops, ns / middle_ops, "ns/op");
+
+		ns = best_ns([&] {
+			C c = filled;
+			auto middle = std::next(c.begin(), static_cast<std::ptrdiff_t>(elements / 2));
+			return time_ns([&] {
+				for (std::size_t i = 0; i < middle_ops && !c.empty(); i++) {
+					if constexpr (Traits<C>::random_access)
+						c.erase(c.begin() + static_cast<std::ptrdiff_t>(c.size() / 2));
+					else
+						middle = c.erase(middle);
+				}
+			});
+		});
+		report("erase_middle", middle_ops, ns / middle_ops, "ns/op");
+
+		ns = best_ns([&] {
+			return time_ns([&] {
+				C copy = filled;
+				sink += copy.size();
+			});
+		});
+		report("copy", elements, ns / elements, "ns/op");
+
+		ns = best_ns([&] {
+			C c = filled;
+			return time_ns([&] {
+				if constexpr (Traits<C>::random_access)
+					std::sort(c.begin(), c.end());
+				else
+					c.sort();
+			});
+		});
+		report("sort", elements, ns / elements, "ns/op");
+
+		std::size_t before = allocated_bytes;
+		{
+			C c = make<C>(elements);
+			std::size_t bytes = allocated_bytes - before + Traits<C>::overhead(c) + sizeof(C);
+			report("footprint", elements, static_cast<double>(bytes) / elements, "bytes/element");
+		}
+	}
+
+	template <std::size_t Bytes>
+	void run_element_size(std::size_t elements) {
+		using T = Element<Bytes>;
+		run<std::vector<T, CountingAllocator<T>>>("vector", elements);
+		run<std::deque<T, CountingAllocator<T>>>("deque", elements);
+		run<std::list<T, CountingAllocator<T>>>("list", elements);
+		run<ChunkList<T, 16, CountingAllocator<T>>>("ChunkList", elements);
+		run<ChunkList<T, 64, CountingAllocator<T>>>("ChunkList", elements);
+		run<ChunkList<T, 256, CountingAllocator<T>>>("ChunkList", elements);
+		run<ChunkList<T, 1024, CountingAllocator<T>>>("ChunkList", elements);
+	}
+}
+
+int main(int argc, char** argv) {
+	std::size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t(1) << 16;
+	if (elements == 0) {
+		std::fprintf(stderr, "usage: %s [elements]\n", argv[0]);
+		return 1;
+	}
+
+	std::printf("container,chunk_size,element_bytes,benchmark,elements,value,unit\n");
+	run_element_size<4>(elements);
+	run_element_size<16>(elements);
+	run_element_size<64>(elements);
+	std::fprintf(stderr, "checksum %llu\n", static_cast<unsigned long long>(sink));
+	return 0;
+}
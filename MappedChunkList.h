@@ -0,0 +1,518 @@
+#pragma once
+#include "Chunk.h"
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace fefu_laboratory_two {
+	/// @brief Position of a block inside a mapped region, counted from the start
+	/// of the region. Offsets stay valid wherever the region is mapped; 0 is the
+	/// null offset.
+	using region_offset = std::uint64_t;
+
+	/// @brief Chunk as laid out in a mapped region. Links are offsets from the
+	/// start of the region.
+	template <typename T, std::size_t N>
+	struct MappedChunk {
+		region_offset prev;
+		region_offset next;
+		std::uint64_t num_of_elements;
+		T list[N];
+	};
+
+	/// @brief Shared mapping of a whole file or shared memory object that can
+	/// grow.
+	class MappedFileRegion {
+	public:
+		MappedFileRegion() = default;
+
+		/// @brief Opens or creates the file at path and maps it for reading and
+		/// writing.
+		/// @param path file to map
+		/// @throw std::system_error if the file cannot be opened or mapped
+		explicit MappedFileRegion(const std::string& path)
+			: MappedFileRegion(::open(path.c_str(), O_RDWR | O_CREAT, 0644), true, path)
+		{
+		}
+
+		/// @brief Maps the whole object behind an open descriptor and takes
+		/// ownership of the descriptor.
+		/// @param fd descriptor returned by open or shm_open, or -1 with errno set
+		/// @param writable whether the mapping is writable
+		/// @param name used in error messages
+		/// @throw std::system_error if fd is invalid or cannot be mapped
+		MappedFileRegion(int fd, bool writable, const std::string& name)
+			: fd(fd), writable(writable)
+		{
+			if (fd < 0)
+				throw std::system_error(errno, std::generic_category(), "open " + name);
+			struct stat st;
+			if (::fstat(fd, &st) != 0) {
+				int error = errno;
+				::close(fd);
+				throw std::system_error(error, std::generic_category(), "fstat " + name);
+			}
+			length = static_cast<std::size_t>(st.st_size);
+			if (length > 0)
+				map(length);
+		}
+
+		MappedFileRegion(const MappedFileRegion&) = delete;
+		MappedFileRegion& operator=(const MappedFileRegion&) = delete;
+
+		MappedFileRegion(MappedFileRegion&& other) noexcept
+			: fd(other.fd), writable(other.writable), base(other.base), length(other.length)
+		{
+			other.fd = -1;
+			other.base = nullptr;
+			other.length = 0;
+		}
+
+		~MappedFileRegion() {
+			if (base != nullptr)
+				::munmap(base, length);
+			if (fd >= 0)
+				::close(fd);
+		}
+
+		char* data() const noexcept { return static_cast<char*>(base); }
+
+		std::size_t size() const noexcept { return length; }
+
+		static std::size_t page_size() noexcept {
+			return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+		}
+
+		/// @brief Extends the file to new_size bytes and maps the new range. The
+		/// mapping may move, offsets into it stay valid.
+		/// @throw std::system_error if the file cannot be extended or remapped
+		void grow(std::size_t new_size) {
+			if (new_size <= length)
+				return;
+			if (::ftruncate(fd, static_cast<off_t>(new_size)) != 0)
+				throw std::system_error(errno, std::generic_category(), "ftruncate");
+			remap(new_size);
+		}
+
+		/// @brief Maps the first new_size bytes of an object grown by another
+		/// process. The mapping may move.
+		/// @throw std::system_error if the range cannot be remapped
+		void remap(std::size_t new_size) {
+			if (new_size <= length)
+				return;
+			if (base == nullptr) {
+				map(new_size);
+				return;
+			}
+#ifdef MREMAP_MAYMOVE
+			void* moved = ::mremap(base, length, new_size, MREMAP_MAYMOVE);
+			if (moved == MAP_FAILED)
+				throw std::system_error(errno, std::generic_category(), "mremap");
+			base = moved;
+#else
+			::munmap(base, length);
+			base = nullptr;
+			map(new_size);
+#endif
+			length = new_size;
+		}
+
+		/// @brief Writes the dirty pages of [offset, offset + count) back to the
+		/// file and waits for the write to complete.
+		/// @throw std::system_error if msync fails
+		void sync(std::size_t offset, std::size_t count) {
+			if (count == 0)
+				return;
+			std::size_t page = page_size();
+			std::size_t begin = offset / page * page;
+			if (::msync(data() + begin, offset + count - begin, MS_SYNC) != 0)
+				throw std::system_error(errno, std::generic_category(), "msync");
+		}
+
+	private:
+		void map(std::size_t size) {
+			int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+			void* mapped = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+			if (mapped == MAP_FAILED)
+				throw std::system_error(errno, std::generic_category(), "mmap");
+			base = mapped;
+			length = size;
+		}
+
+		int fd = -1;
+		bool writable = true;
+		void* base = nullptr;
+		std::size_t length = 0;
+	};
+
+	/// @brief ChunkList whose chunks live in a memory-mapped file.
+	///
+	/// Chunks are linked by offsets from the start of the file instead of
+	/// pointers, so reopening the file gives back a usable list without any
+	/// deserialization. The file grows by whole chunks as elements are added.
+	///
+	/// sync() is a durability point: it flushes the chunks and then commits the
+	/// list state in the file header. Reopening a file restores the state of
+	/// the last sync(); elements appended after it are discarded, in-place
+	/// overwrites of synced elements are not journaled. The destructor syncs.
+	///
+	/// Until the next sync(), the committed elements and the prev links of
+	/// the committed chunks are never written by the modifiers: appending over
+	/// a committed element moves the last chunk to a fresh one first, and
+	/// chunks emptied by pop_back and clear are reused only once no committed
+	/// state refers to them. Reopening rebuilds the next links and the
+	/// element counts of the committed chunks from the prev links and the
+	/// committed size.
+	///
+	/// References returned by element access are invalidated when the file
+	/// grows.
+	/// @tparam T trivially copyable type of the elements
+	/// @tparam N capacity of a chunk
+	template <typename T, std::size_t N = default_chunk_size<T>()>
+	class MappedChunkList {
+		static_assert(std::is_trivially_copyable_v<T>, "Elements of a mapped list must be trivially copyable");
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+		/// @brief Identifies the file format, "CHNKLIST".
+		static constexpr std::uint64_t magic = 0x5453494c4b4e4843ull;
+		static constexpr std::uint32_t format_version = 2;
+
+		/// @brief Opens the list stored at path, creating an empty list if the
+		/// file does not exist or is empty.
+		/// @param path file holding the list
+		/// @throw std::system_error if the file cannot be opened, mapped or grown
+		/// @throw std::runtime_error if the file holds a list of another format,
+		/// element size or chunk size
+		explicit MappedChunkList(const std::string& path) : region(path) {
+			if (region.size() == 0) {
+				region.grow(MappedFileRegion::page_size() + sizeof(chunk_block));
+				list_header* header = new (region.data()) list_header();
+				header->magic = magic;
+				header->format_version = format_version;
+				header->value_size = sizeof(T);
+				header->chunk_size = N;
+				header->live.used_bytes = MappedFileRegion::page_size();
+				header->committed = header->live;
+				region.sync(0, sizeof(list_header));
+				return;
+			}
+			if (region.size() < sizeof(list_header))
+				throw std::runtime_error("Mapped list file is truncated");
+			list_header* header = state_header();
+			if (header->magic != magic || header->format_version != format_version)
+				throw std::runtime_error("File does not hold a mapped list");
+			if (header->value_size != sizeof(T) || header->chunk_size != N)
+				throw std::runtime_error("Mapped list was written with another element or chunk size");
+
+			// Roll back to the last committed state. The prev links of the
+			// committed chunks are intact, their next links and counts may have
+			// changed since
+			list_state& live = header->live;
+			live = header->committed;
+			region_offset next = 0;
+			for (region_offset off = live.tail_chunk; off != 0; off = block(off)->prev) {
+				block(off)->next = next;
+				next = off;
+			}
+			std::uint64_t remaining = live.list_size;
+			for (region_offset off = live.first_chunk; off != 0; off = block(off)->next) {
+				block(off)->num_of_elements = std::min<std::uint64_t>(remaining, N);
+				remaining -= block(off)->num_of_elements;
+			}
+			collect_spare_chunks();
+		}
+
+		MappedChunkList(const MappedChunkList&) = delete;
+		MappedChunkList& operator=(const MappedChunkList&) = delete;
+
+		MappedChunkList(MappedChunkList&& other) noexcept = default;
+
+		/// @brief Syncs the list and unmaps the file.
+		~MappedChunkList() {
+			if (region.data() == nullptr)
+				return;
+			try {
+				sync();
+			}
+			catch (const std::system_error&) {
+			}
+		};
+
+		/// ELEMENT ACCESS
+
+		/// @brief Returns a reference to the element at specified location pos, with
+		/// bounds checking.
+		/// @param pos position of the element to return
+		/// @return Reference to the requested element.
+		/// @throw std::out_of_range
+		reference at(size_type pos) {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @brief Returns a const reference to the element at specified location pos,
+		/// with bounds checking.
+		/// @param pos position of the element to return
+		/// @return Const Reference to the requested element.
+		/// @throw std::out_of_range
+		const_reference at(size_type pos) const {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @brief Returns a reference to the element at specified location pos. No
+		/// bounds checking is performed.
+		reference operator[](size_type pos) {
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			chunk_block* curr_chunk = block(state().first_chunk);
+			while (chunk_index > 0) {
+				curr_chunk = block(curr_chunk->next);
+				chunk_index--;
+			}
+			return curr_chunk->list[offset];
+		};
+
+		const_reference operator[](size_type pos) const {
+			return const_cast<MappedChunkList&>(*this)[pos];
+		};
+
+		reference front() {
+			if (empty())
+				throw std::logic_error("Empty");
+			return block(state().first_chunk)->list[0];
+		};
+
+		reference back() {
+			if (empty())
+				throw std::logic_error("Empty");
+			chunk_block* tail = block(state().tail_chunk);
+			return tail->list[tail->num_of_elements - 1];
+		};
+
+		/// CAPACITY
+
+		bool empty() const noexcept { return size() == 0; };
+
+		size_type size() const noexcept { return state().list_size; };
+
+		/// @brief Returns the number of chunks stored in the file, including the
+		/// spare chunks left after pop_back and clear.
+		size_type chunk_count() const noexcept { return state().num_of_chunks; };
+
+		/// MODIFIERS
+
+		/// @brief Appends the given element value to the end of the list, growing
+		/// the file if no chunk has room for it.
+		void push_back(const T& value) {
+			chunk_block* tail = back_chunk_with_room();
+			tail->list[tail->num_of_elements++] = value;
+			state().list_size++;
+		};
+
+		/// @brief Removes the last element. The chunk it leaves empty is kept as
+		/// spare capacity.
+		void pop_back() {
+			if (empty())
+				return;
+			list_state& live = state();
+			region_offset off = live.tail_chunk;
+			chunk_block* tail = block(off);
+			tail->num_of_elements--;
+			live.list_size--;
+			if (tail->num_of_elements == 0) {
+				live.tail_chunk = tail->prev;
+				if (tail->prev != 0)
+					block(tail->prev)->next = 0;
+				else
+					live.first_chunk = 0;
+				release(off);
+			}
+		};
+
+		/// @brief Removes all elements, keeping the chunks as spare capacity.
+		void clear() {
+			list_state& live = state();
+			for (region_offset off = live.first_chunk; off != 0;) {
+				region_offset next = block(off)->next;
+				release(off);
+				off = next;
+			}
+			live.list_size = 0;
+			live.first_chunk = 0;
+			live.tail_chunk = 0;
+		};
+
+		/// @brief Durability point. Flushes the chunks to the file, then commits
+		/// the list state in the file header. The chunks only the previous
+		/// state referred to become spare capacity.
+		/// @throw std::system_error if msync fails
+		void sync() {
+			std::size_t header_page = MappedFileRegion::page_size();
+			list_header* header = state_header();
+			region.sync(header_page, header->live.used_bytes - header_page);
+			header->committed = header->live;
+			region.sync(0, sizeof(list_header));
+			collect_spare_chunks();
+		};
+
+		/// @brief Calls f for every element, in order, walking the chunks.
+		template <class F>
+		void for_each(F f) const {
+			for (region_offset off = state().first_chunk; off != 0; off = block(off)->next) {
+				const chunk_block* chunk = block(off);
+				for (std::uint64_t i = 0; i < chunk->num_of_elements; i++)
+					f(chunk->list[i]);
+			}
+		};
+
+	private:
+		using chunk_block = MappedChunk<T, N>;
+
+		/// @brief Links and sizes of the list. Every chunk between first_chunk
+		/// and tail_chunk is full except the tail.
+		struct list_state {
+			std::uint64_t list_size = 0;
+			std::uint64_t num_of_chunks = 0;
+			region_offset first_chunk = 0;
+			region_offset tail_chunk = 0;
+			std::uint64_t used_bytes = 0;
+		};
+
+		/// @brief First page of the file. live is updated by every operation,
+		/// committed only by sync().
+		struct list_header {
+			std::uint64_t magic = 0;
+			std::uint32_t format_version = 0;
+			std::uint32_t value_size = 0;
+			std::uint64_t chunk_size = 0;
+			list_state live;
+			list_state committed;
+		};
+
+		list_header* state_header() const noexcept {
+			return reinterpret_cast<list_header*>(region.data());
+		}
+
+		list_state& state() const noexcept { return state_header()->live; }
+
+		chunk_block* block(region_offset off) const noexcept {
+			return reinterpret_cast<chunk_block*>(region.data() + off);
+		}
+
+		/// @brief Returns the index of the chunk at off among the chunks of the
+		/// file.
+		static std::size_t chunk_index(region_offset off) noexcept {
+			return (off - MappedFileRegion::page_size()) / sizeof(chunk_block);
+		}
+
+		/// @brief Returns whether the chunk at off belongs to the committed state.
+		bool is_committed(region_offset off) const noexcept {
+			return committed_chunks[chunk_index(off)];
+		}
+
+		/// @brief Makes a chunk dropped from the list spare capacity, unless the
+		/// committed state still refers to it; sync() collects those.
+		void release(region_offset off) {
+			if (!is_committed(off))
+				spare_chunks.push_back(off);
+		}
+
+		/// @brief Marks the chunks of the list as committed and makes every
+		/// other chunk of the file spare capacity.
+		void collect_spare_chunks() {
+			const list_state& live = state();
+			std::size_t page = MappedFileRegion::page_size();
+			committed_chunks.assign((live.used_bytes - page) / sizeof(chunk_block), false);
+			for (region_offset off = live.first_chunk; off != 0; off = block(off)->next)
+				committed_chunks[chunk_index(off)] = true;
+			spare_chunks.clear();
+			for (std::size_t i = committed_chunks.size(); i > 0; i--)
+				if (!committed_chunks[i - 1])
+					spare_chunks.push_back(page + (i - 1) * sizeof(chunk_block));
+		}
+
+		/// @brief Returns an unlinked empty chunk, reusing a spare chunk or
+		/// appending a new one at the end of the file.
+		region_offset new_chunk() {
+			region_offset off;
+			if (!spare_chunks.empty()) {
+				off = spare_chunks.back();
+				spare_chunks.pop_back();
+			}
+			else {
+				std::size_t needed = state().used_bytes + sizeof(chunk_block);
+				if (needed > region.size()) {
+					std::size_t page = MappedFileRegion::page_size();
+					std::size_t new_size = std::max(region.size() * 2, needed);
+					region.grow((new_size + page - 1) / page * page);
+				}
+				list_state& grown = state();
+				off = grown.used_bytes;
+				grown.used_bytes = needed;
+				grown.num_of_chunks++;
+				committed_chunks.push_back(false);
+			}
+			chunk_block* chunk = block(off);
+			chunk->prev = 0;
+			chunk->next = 0;
+			chunk->num_of_elements = 0;
+			return off;
+		}
+
+		/// @brief Returns the chunk receiving the next element. A tail whose next
+		/// slot holds a committed element is first moved to a new chunk, and a
+		/// full tail gets a new chunk linked after it.
+		chunk_block* back_chunk_with_room() {
+			region_offset tail_off = state().tail_chunk;
+			if (tail_off != 0) {
+				chunk_block* tail = block(tail_off);
+				if (tail->num_of_elements < N
+					&& !(is_committed(tail_off) && state().list_size < state_header()->committed.list_size))
+					return tail;
+			}
+
+			region_offset off = new_chunk();
+			list_state& live = state();
+			chunk_block* chunk = block(off);
+			region_offset prev = tail_off;
+			if (tail_off != 0) {
+				chunk_block* tail = block(tail_off);
+				if (tail->num_of_elements < N) {
+					// Copy the elements before the committed slot and drop the tail
+					std::memcpy(chunk->list, tail->list, tail->num_of_elements * sizeof(T));
+					chunk->num_of_elements = tail->num_of_elements;
+					prev = tail->prev;
+				}
+			}
+			chunk->prev = prev;
+			if (prev != 0)
+				block(prev)->next = off;
+			else
+				live.first_chunk = off;
+			live.tail_chunk = off;
+			return chunk;
+		}
+
+		MappedFileRegion region;
+		/// @brief Per chunk of the file, whether the committed state refers to it.
+		std::vector<bool> committed_chunks;
+		/// @brief Chunks of the file no state refers to.
+		std::vector<region_offset> spare_chunks;
+	};
+}  // namespace fefu_laboratory_two
@@ -0,0 +1,305 @@
+#pragma once
+#include "MappedChunkList.h"
+#include <atomic>
+
+
+namespace fefu_laboratory_two {
+	/// @brief First page of a shared memory segment holding a ChunkList.
+	///
+	/// published_size is the publication point: the writer stores it with
+	/// release semantics after the elements and chunk links below it are
+	/// written, readers load it with acquire semantics and never look past it.
+	/// arena_size is stored before published_size whenever the segment grows, so
+	/// readers know how much of the segment to map.
+	struct SharedListHeader {
+		std::uint64_t magic = 0;
+		std::uint32_t format_version = 0;
+		std::uint32_t value_size = 0;
+		std::uint64_t chunk_size = 0;
+		std::atomic<std::uint64_t> published_size{ 0 };
+		std::atomic<std::uint64_t> arena_size{ 0 };
+		region_offset first_chunk = 0;
+
+		// Writer bookkeeping, never read by readers
+		region_offset tail_chunk = 0;
+		std::uint64_t list_size = 0;
+		std::uint64_t num_of_chunks = 0;
+		std::uint64_t used_bytes = 0;
+	};
+
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+		"Shared list counters must be lock-free to work across processes");
+
+	/// @brief Writer side of a ChunkList placed in a POSIX shared memory segment.
+	///
+	/// Chunks are carved out of the segment by a bump allocator and linked by
+	/// offsets, so every process can map the segment at its own address. One
+	/// process writes, any number of SharedChunkListReader processes read.
+	/// Appended elements become visible to readers when publish() is called or
+	/// when the chunk they are in is full; readers never see a partially
+	/// written element or chunk.
+	///
+	/// The list is append-only: published elements must not change under the
+	/// readers.
+	/// @tparam T trivially copyable type of the elements
+	/// @tparam N capacity of a chunk
+	template <typename T, std::size_t N = default_chunk_size<T>()>
+	class SharedChunkList {
+		static_assert(std::is_trivially_copyable_v<T>, "Elements of a shared list must be trivially copyable");
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+		/// @brief Identifies the segment format, "CHNKSHRD".
+		static constexpr std::uint64_t magic = 0x445248534b4e4843ull;
+		static constexpr std::uint32_t format_version = 1;
+
+		/// @brief Creates an empty list in a new shared memory segment. A segment
+		/// left under the same name is unlinked first; readers still attached to
+		/// it keep their mapping.
+		/// @param name shared memory object name, starting with '/'
+		/// @throw std::system_error if the segment cannot be created or mapped
+		explicit SharedChunkList(const std::string& name) : region(create_segment(name), true, name) {
+			region.grow(MappedFileRegion::page_size() + sizeof(chunk_block));
+			SharedListHeader* header = new (region.data()) SharedListHeader();
+			header->magic = magic;
+			header->format_version = format_version;
+			header->value_size = sizeof(T);
+			header->chunk_size = N;
+			header->used_bytes = MappedFileRegion::page_size();
+			header->arena_size.store(region.size(), std::memory_order_release);
+		}
+
+		SharedChunkList(const SharedChunkList&) = delete;
+		SharedChunkList& operator=(const SharedChunkList&) = delete;
+
+		SharedChunkList(SharedChunkList&& other) noexcept = default;
+
+		/// @brief Publishes the remaining elements and unmaps the segment. The
+		/// segment stays available to readers until remove() is called.
+		~SharedChunkList() {
+			if (region.data() != nullptr)
+				publish();
+		};
+
+		/// @brief Removes the segment name. Mapped segments stay valid until every
+		/// process unmaps them.
+		static void remove(const std::string& name) noexcept {
+			::shm_unlink(name.c_str());
+		}
+
+		/// ELEMENT ACCESS
+
+		/// @throw std::out_of_range
+		reference at(size_type pos) {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @brief Returns a reference to the element at specified location pos. No
+		/// bounds checking is performed. Published elements must not be changed.
+		reference operator[](size_type pos) {
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			chunk_block* curr_chunk = block(header()->first_chunk);
+			while (chunk_index > 0) {
+				curr_chunk = block(curr_chunk->next);
+				chunk_index--;
+			}
+			return curr_chunk->list[offset];
+		};
+
+		/// CAPACITY
+
+		bool empty() const noexcept { return size() == 0; };
+
+		/// @brief Returns the number of appended elements, published or not.
+		size_type size() const noexcept { return header()->list_size; };
+
+		/// @brief Returns the number of elements visible to readers.
+		size_type published_size() const noexcept {
+			return header()->published_size.load(std::memory_order_relaxed);
+		};
+
+		size_type chunk_count() const noexcept { return header()->num_of_chunks; };
+
+		/// MODIFIERS
+
+		/// @brief Appends value. It becomes visible to readers once its chunk is
+		/// full or publish() is called.
+		void push_back(const T& value) {
+			chunk_block* tail = back_chunk_with_room();
+			tail->list[tail->num_of_elements++] = value;
+			header()->list_size++;
+			if (tail->num_of_elements == N)
+				publish();
+		};
+
+		/// @brief Makes every appended element visible to readers.
+		void publish() noexcept {
+			SharedListHeader* shared = header();
+			shared->published_size.store(shared->list_size, std::memory_order_release);
+		};
+
+	private:
+		using chunk_block = MappedChunk<T, N>;
+
+		static int create_segment(const std::string& name) {
+			::shm_unlink(name.c_str());
+			return ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+		}
+
+		SharedListHeader* header() const noexcept {
+			return reinterpret_cast<SharedListHeader*>(region.data());
+		}
+
+		chunk_block* block(region_offset off) const noexcept {
+			return reinterpret_cast<chunk_block*>(region.data() + off);
+		}
+
+		/// @brief Allocates a chunk from the shared arena, growing the segment if
+		/// needed. The new size is announced before the chunk can be published.
+		region_offset allocate_chunk() {
+			std::size_t needed = header()->used_bytes + sizeof(chunk_block);
+			if (needed > region.size()) {
+				std::size_t page = MappedFileRegion::page_size();
+				std::size_t new_size = std::max(region.size() * 2, needed);
+				region.grow((new_size + page - 1) / page * page);
+				header()->arena_size.store(region.size(), std::memory_order_release);
+			}
+			region_offset off = header()->used_bytes;
+			header()->used_bytes = needed;
+			return off;
+		}
+
+		chunk_block* back_chunk_with_room() {
+			SharedListHeader* shared = header();
+			if (shared->tail_chunk != 0 && block(shared->tail_chunk)->num_of_elements < N)
+				return block(shared->tail_chunk);
+
+			region_offset off = allocate_chunk();
+			shared = header();
+			chunk_block* chunk = block(off);
+			chunk->prev = shared->tail_chunk;
+			chunk->next = 0;
+			chunk->num_of_elements = 0;
+			// Readers follow this link only after a later release of published_size
+			if (shared->tail_chunk != 0)
+				block(shared->tail_chunk)->next = off;
+			else
+				shared->first_chunk = off;
+			shared->tail_chunk = off;
+			shared->num_of_chunks++;
+			return chunk;
+		}
+
+		MappedFileRegion region;
+	};
+
+	/// @brief Reader side of a SharedChunkList, mapping the segment read-only.
+	///
+	/// A reader works on a snapshot: refresh() acquires the elements published
+	/// since the last call, and element access is bounded by the snapshot size.
+	/// @tparam T type of the elements, must match the writer
+	/// @tparam N capacity of a chunk, must match the writer
+	template <typename T, std::size_t N = default_chunk_size<T>()>
+	class SharedChunkListReader {
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using const_reference = const value_type&;
+
+		/// @brief Attaches to the segment created by a SharedChunkList and takes a
+		/// first snapshot.
+		/// @param name shared memory object name, starting with '/'
+		/// @throw std::system_error if the segment cannot be opened or mapped
+		/// @throw std::runtime_error if the segment holds a list of another
+		/// format, element size or chunk size
+		explicit SharedChunkListReader(const std::string& name)
+			: region(::shm_open(name.c_str(), O_RDONLY, 0), false, name)
+		{
+			if (region.size() < sizeof(SharedListHeader))
+				throw std::runtime_error("Shared list segment is not initialized");
+			const SharedListHeader* shared = header();
+			if (shared->magic != SharedChunkList<T, N>::magic || shared->format_version != SharedChunkList<T, N>::format_version)
+				throw std::runtime_error("Segment does not hold a shared list");
+			if (shared->value_size != sizeof(T) || shared->chunk_size != N)
+				throw std::runtime_error("Shared list was written with another element or chunk size");
+			refresh();
+		}
+
+		/// @brief Acquires the elements published so far, mapping the part of the
+		/// segment added by the writer since the last call.
+		/// @return The new snapshot size.
+		size_type refresh() {
+			const SharedListHeader* shared = header();
+			size_type published = shared->published_size.load(std::memory_order_acquire);
+			std::size_t arena = shared->arena_size.load(std::memory_order_acquire);
+			region.remap(arena);
+			snapshot_size = published;
+			return snapshot_size;
+		}
+
+		/// @brief Returns the number of elements in the snapshot.
+		size_type size() const noexcept { return snapshot_size; };
+
+		bool empty() const noexcept { return snapshot_size == 0; };
+
+		/// @throw std::out_of_range
+		const_reference at(size_type pos) const {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @brief Returns the element at pos of the snapshot. No bounds checking is
+		/// performed.
+		const_reference operator[](size_type pos) const {
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			const chunk_block* curr_chunk = block(header()->first_chunk);
+			while (chunk_index > 0) {
+				curr_chunk = block(curr_chunk->next);
+				chunk_index--;
+			}
+			return curr_chunk->list[offset];
+		};
+
+		/// @brief Calls f for every element of the snapshot, walking the chunks.
+		template <class F>
+		void for_each(F f) const {
+			size_type remaining = snapshot_size;
+			if (remaining == 0)
+				return;
+			const chunk_block* chunk = block(header()->first_chunk);
+			while (true) {
+				size_type count = std::min<size_type>(remaining, N);
+				for (size_type i = 0; i < count; i++)
+					f(chunk->list[i]);
+				remaining -= count;
+				// The link after the last chunk of the snapshot may be written by
+				// the writer at any time
+				if (remaining == 0)
+					break;
+				chunk = block(chunk->next);
+			}
+		};
+
+	private:
+		using chunk_block = MappedChunk<T, N>;
+
+		const SharedListHeader* header() const noexcept {
+			return reinterpret_cast<const SharedListHeader*>(region.data());
+		}
+
+		const chunk_block* block(region_offset off) const noexcept {
+			return reinterpret_cast<const chunk_block*>(region.data() + off);
+		}
+
+		MappedFileRegion region;
+		size_type snapshot_size = 0;
+	};
+}  // namespace fefu_laboratory_two
@@ -0,0 +1,403 @@
+#pragma once
+#include "Chunk.h"
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+namespace fefu_laboratory_two {
+	/// @brief ChunkList keeping its elements in order.
+	///
+	/// The smallest and largest key of every chunk are kept in two compact
+	/// arrays of fence keys. A lookup binary-searches the fences to pick a
+	/// chunk, then binary-searches inside that chunk. Both searches run over
+	/// contiguous memory, so a lookup costs O(log n) with few cache misses.
+	///
+	/// A chunk that fills up is split in two. A chunk that drops below a quarter
+	/// full is merged with a neighbour if the result leaves room for inserts.
+	/// Elements are ordered by Compare and equal elements keep their insertion
+	/// order.
+	/// @tparam T type of the elements
+	/// @tparam N capacity of a chunk
+	/// @tparam Compare strict weak ordering of the elements
+	template <typename T, std::size_t N = default_chunk_size<T>(), typename Compare = std::less<T>,
+		typename Allocator = Allocator<T>>
+	class SortedChunkList {
+		static_assert(N >= 4, "Sorted chunks must hold at least 4 elements to split and merge");
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using key_compare = Compare;
+		using const_reference = const value_type&;
+
+		/// @brief Bidirectional iterator over the elements in order. Elements are
+		/// keys and cannot be changed in place.
+		class const_iterator {
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const T*;
+			using reference = const T&;
+
+			const_iterator() = default;
+
+			reference operator*() const { return list->chunks[chunk_index]->list[offset]; }
+
+			pointer operator->() const { return &**this; }
+
+			const_iterator& operator++() {
+				if (++offset == list->chunks[chunk_index]->num_of_elements) {
+					chunk_index++;
+					offset = 0;
+				}
+				return *this;
+			}
+
+			const_iterator operator++(int) {
+				const_iterator tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			const_iterator& operator--() {
+				if (offset == 0) {
+					chunk_index--;
+					offset = list->chunks[chunk_index]->num_of_elements;
+				}
+				offset--;
+				return *this;
+			}
+
+			const_iterator operator--(int) {
+				const_iterator tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+				return lhs.chunk_index == rhs.chunk_index && lhs.offset == rhs.offset;
+			}
+
+		private:
+			friend class SortedChunkList;
+
+			const_iterator(const SortedChunkList* list, size_type chunk_index, size_type offset)
+				: list(list), chunk_index(chunk_index), offset(offset) {}
+
+			const SortedChunkList* list = nullptr;
+			size_type chunk_index = 0;
+			size_type offset = 0;
+		};
+
+		using iterator = const_iterator;
+
+		SortedChunkList() {};
+
+		explicit SortedChunkList(const Compare& comp, const Allocator& alloc = Allocator())
+			: comp(comp), allocator(alloc) {};
+
+		/// @brief Constructs the container with the elements of init in order.
+		SortedChunkList(std::initializer_list<T> init, const Compare& comp = Compare())
+			: comp(comp)
+		{
+			for (const T& value : init)
+				insert_sorted(value);
+		};
+
+		SortedChunkList(const SortedChunkList& other)
+			: fence_min(other.fence_min), fence_max(other.fence_max), list_size(other.list_size),
+			comp(other.comp), allocator(other.allocator)
+		{
+			chunks.reserve(other.chunks.size());
+			for (chunk_type* chunk : other.chunks) {
+				chunk_type* copy = new chunk_type(N, allocator);
+				std::copy(chunk->begin(), chunk->end(), copy->list);
+				copy->num_of_elements = chunk->num_of_elements;
+				chunks.push_back(copy);
+			}
+		};
+
+		SortedChunkList(SortedChunkList&& other) noexcept {
+			swap(other);
+		};
+
+		~SortedChunkList() {
+			clear();
+		};
+
+		SortedChunkList& operator=(SortedChunkList other) noexcept {
+			swap(other);
+			return *this;
+		};
+
+		/// @brief Replaces the contents with the sorted range [first, last) in one
+		/// pass. Chunks are filled to three quarters to leave room for inserts.
+		/// @throw std::invalid_argument if the range is not sorted
+		template <class InputIt>
+		void assign_sorted(InputIt first, InputIt last) {
+			clear();
+			const size_type fill = N - N / 4;
+			for (; first != last; ++first) {
+				if (list_size > 0 && comp(*first, fence_max.back()))
+					throw std::invalid_argument("Range is not sorted");
+				if (chunks.empty() || chunks.back()->num_of_elements == fill)
+					insert_chunk(chunks.size(), *first);
+				chunk_type* chunk = chunks.back();
+				chunk->list[chunk->num_of_elements++] = *first;
+				fence_max.back() = *first;
+				list_size++;
+			}
+		};
+
+		/// LOOKUP
+
+		/// @brief Returns an iterator to the first element not less than key.
+		const_iterator lower_bound(const T& key) const {
+			size_type chunk_index = std::lower_bound(fence_max.begin(), fence_max.end(), key, comp) - fence_max.begin();
+			if (chunk_index == chunks.size())
+				return end();
+			chunk_type* chunk = chunks[chunk_index];
+			return const_iterator(this, chunk_index, std::lower_bound(chunk->begin(), chunk->end(), key, comp) - chunk->begin());
+		};
+
+		/// @brief Returns an iterator to the first element greater than key.
+		const_iterator upper_bound(const T& key) const {
+			size_type chunk_index = std::upper_bound(fence_max.begin(), fence_max.end(), key, comp) - fence_max.begin();
+			if (chunk_index == chunks.size())
+				return end();
+			chunk_type* chunk = chunks[chunk_index];
+			return const_iterator(this, chunk_index, std::upper_bound(chunk->begin(), chunk->end(), key, comp) - chunk->begin());
+		};
+
+		/// @brief Returns the range of elements equal to key.
+		std::pair<const_iterator, const_iterator> equal_range(const T& key) const {
+			return { lower_bound(key), upper_bound(key) };
+		};
+
+		/// @brief Returns an iterator to an element equal to key, or end().
+		const_iterator find(const T& key) const {
+			const_iterator it = lower_bound(key);
+			if (it == end() || comp(key, *it))
+				return end();
+			return it;
+		};
+
+		bool contains(const T& key) const {
+			return find(key) != end();
+		};
+
+		/// @brief Returns the number of elements equal to key.
+		size_type count(const T& key) const {
+			auto [first, last] = equal_range(key);
+			size_type result = 0;
+			for (; first != last; ++first)
+				result++;
+			return result;
+		};
+
+		/// ELEMENT ACCESS
+
+		/// @brief Returns the element at position pos in order. Walks the chunk
+		/// sizes, O(chunk_count()).
+		/// @throw std::out_of_range
+		const_reference at(size_type pos) const {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			for (chunk_type* chunk : chunks) {
+				if (pos < chunk->num_of_elements)
+					return chunk->list[pos];
+				pos -= chunk->num_of_elements;
+			}
+			return chunks.back()->list[0];
+		};
+
+		const_reference operator[](size_type pos) const { return at(pos); };
+
+		const_reference front() const {
+			if (list_size == 0)
+				throw std::logic_error("Empty");
+			return chunks.front()->list[0];
+		};
+
+		const_reference back() const {
+			if (list_size == 0)
+				throw std::logic_error("Empty");
+			return fence_max.back();
+		};
+
+		/// ITERATORS
+
+		const_iterator begin() const noexcept { return const_iterator(this, 0, 0); };
+
+		const_iterator end() const noexcept { return const_iterator(this, chunks.size(), 0); };
+
+		const_iterator cbegin() const noexcept { return begin(); };
+
+		const_iterator cend() const noexcept { return end(); };
+
+		/// CAPACITY
+
+		bool empty() const noexcept { return list_size == 0; };
+
+		size_type size() const noexcept { return list_size; };
+
+		size_type chunk_count() const noexcept { return chunks.size(); };
+
+		/// MODIFIERS
+
+		/// @brief Inserts value after the elements equal to it.
+		/// @return Iterator to the inserted element.
+		const_iterator insert_sorted(const T& value) {
+			if (chunks.empty())
+				insert_chunk(0, value);
+
+			// The first chunk whose largest key is greater than value, or the last
+			size_type chunk_index = std::upper_bound(fence_max.begin(), fence_max.end(), value, comp) - fence_max.begin();
+			if (chunk_index == chunks.size())
+				chunk_index--;
+			// Between two chunks, append to the previous one rather than split
+			if (chunk_index > 0 && chunks[chunk_index]->num_of_elements == N && comp(value, fence_min[chunk_index])
+				&& chunks[chunk_index - 1]->num_of_elements < N)
+				chunk_index--;
+			if (chunks[chunk_index]->num_of_elements == N) {
+				split(chunk_index);
+				if (!comp(value, fence_min[chunk_index + 1]))
+					chunk_index++;
+			}
+
+			chunk_type* chunk = chunks[chunk_index];
+			T* pos = std::upper_bound(chunk->begin(), chunk->end(), value, comp);
+			std::move_backward(pos, chunk->end(), chunk->end() + 1);
+			*pos = value;
+			chunk->num_of_elements++;
+			list_size++;
+			fence_min[chunk_index] = chunk->list[0];
+			fence_max[chunk_index] = chunk->list[chunk->num_of_elements - 1];
+			return const_iterator(this, chunk_index, pos - chunk->begin());
+		};
+
+		/// @brief Removes every element equal to key.
+		/// @return The number of removed elements.
+		size_type erase_key(const T& key) {
+			size_type removed = 0;
+			size_type chunk_index = std::lower_bound(fence_max.begin(), fence_max.end(), key, comp) - fence_max.begin();
+			size_type first_index = chunk_index;
+			while (chunk_index < chunks.size() && !comp(key, fence_min[chunk_index])) {
+				chunk_type* chunk = chunks[chunk_index];
+				T* first = std::lower_bound(chunk->begin(), chunk->end(), key, comp);
+				T* last = std::upper_bound(first, chunk->end(), key, comp);
+				size_type count = last - first;
+				std::move(last, chunk->end(), first);
+				chunk->num_of_elements -= count;
+				list_size -= count;
+				removed += count;
+				if (chunk->num_of_elements == 0) {
+					remove_chunk(chunk_index);
+					continue;
+				}
+				fence_min[chunk_index] = chunk->list[0];
+				fence_max[chunk_index] = chunk->list[chunk->num_of_elements - 1];
+				chunk_index++;
+			}
+			// Every chunk holding only key is gone, so the chunks left at both
+			// ends of the run are the only ones that may have become sparse. The
+			// first is merged last: while the run went on past it, merging it
+			// forward would have pulled in elements equal to key
+			if (removed > 0 && chunk_index > first_index) {
+				merge_if_sparse(chunk_index - 1);
+				if (first_index < chunks.size())
+					merge_if_sparse(first_index);
+			}
+			return removed;
+		};
+
+		void clear() noexcept {
+			for (chunk_type* chunk : chunks)
+				delete chunk;
+			chunks.clear();
+			fence_min.clear();
+			fence_max.clear();
+			list_size = 0;
+		};
+
+		void swap(SortedChunkList& other) noexcept {
+			std::swap(chunks, other.chunks);
+			std::swap(fence_min, other.fence_min);
+			std::swap(fence_max, other.fence_max);
+			std::swap(list_size, other.list_size);
+			std::swap(comp, other.comp);
+			std::swap(allocator, other.allocator);
+		};
+
+	private:
+		using chunk_type = Chunk<T, Allocator>;
+
+		/// @brief Creates an empty chunk at chunk_index with both fences set to
+		/// key.
+		void insert_chunk(size_type chunk_index, const T& key) {
+			chunks.insert(chunks.begin() + chunk_index, new chunk_type(N, allocator));
+			fence_min.insert(fence_min.begin() + chunk_index, key);
+			fence_max.insert(fence_max.begin() + chunk_index, key);
+		}
+
+		void remove_chunk(size_type chunk_index) noexcept {
+			delete chunks[chunk_index];
+			chunks.erase(chunks.begin() + chunk_index);
+			fence_min.erase(fence_min.begin() + chunk_index);
+			fence_max.erase(fence_max.begin() + chunk_index);
+		}
+
+		/// @brief Moves the upper half of a full chunk into a new chunk after it.
+		void split(size_type chunk_index) {
+			chunk_type* chunk = chunks[chunk_index];
+			size_type keep = chunk->num_of_elements / 2;
+			insert_chunk(chunk_index + 1, chunk->list[keep]);
+			chunk_type* upper = chunks[chunk_index + 1];
+			std::move(chunk->begin() + keep, chunk->end(), upper->list);
+			upper->num_of_elements = chunk->num_of_elements - keep;
+			chunk->num_of_elements = keep;
+			fence_max[chunk_index] = chunk->list[keep - 1];
+			fence_max[chunk_index + 1] = upper->list[upper->num_of_elements - 1];
+		}
+
+		/// @brief Merges a chunk under a quarter full with a neighbour when the
+		/// result is at most three quarters full.
+		/// @return Index of the chunk that holds the elements of chunk_index.
+		size_type merge_if_sparse(size_type chunk_index) {
+			if (chunks[chunk_index]->num_of_elements >= N / 4)
+				return chunk_index;
+			auto fits = [this](size_type left) {
+				return chunks[left]->num_of_elements + chunks[left + 1]->num_of_elements <= N - N / 4;
+			};
+			if (chunk_index + 1 < chunks.size() && fits(chunk_index)) {
+				merge_into(chunk_index);
+				return chunk_index;
+			}
+			if (chunk_index > 0 && fits(chunk_index - 1)) {
+				merge_into(chunk_index - 1);
+				return chunk_index - 1;
+			}
+			return chunk_index;
+		}
+
+		/// @brief Appends the elements of the chunk after left to left.
+		void merge_into(size_type left) {
+			chunk_type* chunk = chunks[left];
+			chunk_type* right = chunks[left + 1];
+			std::move(right->begin(), right->end(), chunk->end());
+			chunk->num_of_elements += right->num_of_elements;
+			fence_max[left] = fence_max[left + 1];
+			remove_chunk(left + 1);
+		}
+
+		std::vector<chunk_type*> chunks;
+		std::vector<T> fence_min;
+		std::vector<T> fence_max;
+		size_type list_size = 0;
+		Compare comp;
+		Allocator allocator;
+	};
+}  // namespace fefu_laboratory_two
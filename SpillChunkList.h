@@ -0,0 +1,366 @@
+#pragma once
+#include "Chunk.h"
+#include <cerrno>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace fefu_laboratory_two {
+	/// @brief Counters of a SpillChunkList cache.
+	struct SpillStats {
+		/// @brief Accesses that had to wait for a chunk to be read.
+		std::size_t faults = 0;
+		/// @brief Chunks read ahead of a sequential scan.
+		std::size_t prefetches = 0;
+		/// @brief Accesses served by a chunk that was read ahead.
+		std::size_t prefetch_hits = 0;
+		std::size_t evictions = 0;
+		/// @brief Evicted chunks that had to be written to the spill file.
+		std::size_t writebacks = 0;
+	};
+
+	/// @brief ChunkList for data that does not fit in memory. Chunks over a byte
+	/// budget are evicted to a spill file and read back on access.
+	///
+	/// Chunk k always holds the elements [k * N, (k + 1) * N) and always lives
+	/// at the same spot of the spill file, so positions stay valid across
+	/// eviction. Resident chunks are replaced with the CLOCK algorithm, an LRU
+	/// approximation that only sets a bit on a hit. When accesses move to the
+	/// next chunk, the following chunks are read ahead in the background.
+	///
+	/// A reference returned by element access stays valid until the next access
+	/// to another chunk, which may evict the chunk it points into.
+	///
+	/// Const access is not thread-safe either. It reads chunks back, evicts,
+	/// frees their buffers and starts read-ahead just like non-const access, so
+	/// two threads reading the same list at once race on the cache and one may
+	/// free the chunk the other is reading. Share a list between threads only
+	/// behind a lock held for the access and for every use of its result.
+	/// @tparam T trivially copyable type of the elements
+	/// @tparam N capacity of a chunk
+	template <typename T, std::size_t N = default_chunk_size<T>()>
+	class SpillChunkList {
+		static_assert(std::is_trivially_copyable_v<T>, "Elements of a spilled list must be trivially copyable");
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+		/// @brief Bytes of memory held by one resident chunk.
+		static constexpr size_type chunk_bytes = N * sizeof(T);
+
+		/// @brief Creates an empty list spilling to the file at path. The file is
+		/// truncated and removed when the list is destroyed.
+		/// @param spill_path file to evict chunks to
+		/// @param budget_bytes bound on the memory held by resident chunks
+		/// @param prefetch_depth number of chunks to read ahead of a sequential
+		/// scan, 0 disables read-ahead
+		/// @throw std::invalid_argument if the budget does not fit one chunk
+		/// @throw std::system_error if the file cannot be created
+		SpillChunkList(const std::string& spill_path, size_type budget_bytes, size_type prefetch_depth = 2)
+			: path(spill_path), max_resident(budget_bytes / chunk_bytes)
+		{
+			if (max_resident == 0)
+				throw std::invalid_argument("Spill budget is smaller than a chunk");
+			depth = std::min(prefetch_depth, max_resident - 1);
+			fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+			if (fd < 0)
+				throw std::system_error(errno, std::generic_category(), "open " + path);
+		};
+
+		SpillChunkList(const SpillChunkList&) = delete;
+		SpillChunkList& operator=(const SpillChunkList&) = delete;
+
+		~SpillChunkList() {
+			for (auto& slot : slots)
+				if (slot.loading.valid())
+					slot.loading.wait();
+			::close(fd);
+			::unlink(path.c_str());
+		};
+
+		/// ELEMENT ACCESS
+
+		/// @throw std::out_of_range
+		reference at(size_type pos) {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @throw std::out_of_range
+		const_reference at(size_type pos) const {
+			if (pos >= size())
+				throw std::out_of_range("Out of range");
+			return (*this)[pos];
+		};
+
+		/// @brief Returns a reference to the element at pos, reading its chunk back
+		/// if it was evicted. The chunk is written back when it is evicted again.
+		/// No bounds checking is performed.
+		reference operator[](size_type pos) {
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			slot_type& slot = fault(chunk_index);
+			slot.dirty = true;
+			return slot.data[offset];
+		};
+
+		/// @brief Returns the element at pos, reading its chunk back if it was
+		/// evicted. No bounds checking is performed. Changes the cache, so it is
+		/// not safe to call from several threads at once.
+		const_reference operator[](size_type pos) const {
+			size_type chunk_index, offset;
+			FixedChunkSize<N>().locate(pos, chunk_index, offset);
+			return fault(chunk_index).data[offset];
+		};
+
+		reference front() { return at(0); };
+		const_reference front() const { return at(0); };
+		reference back() { return at(size() - 1); };
+		const_reference back() const { return at(size() - 1); };
+
+		/// @brief Calls f for every element in order, a chunk at a time. The scan
+		/// reads ahead of itself and changes the cache like any other access.
+		template <class F>
+		void for_each(F f) const {
+			for (size_type chunk_index = 0; chunk_index < slots.size(); chunk_index++) {
+				const slot_type& slot = fault(chunk_index);
+				for (size_type i = 0; i < slot.count; i++)
+					f(slot.data[i]);
+			}
+		};
+
+		/// CAPACITY
+
+		bool empty() const noexcept { return list_size == 0; };
+
+		size_type size() const noexcept { return list_size; };
+
+		size_type chunk_count() const noexcept { return slots.size(); };
+
+		/// @brief Returns the number of chunks in memory, including the ones being
+		/// read ahead.
+		size_type resident_chunks() const noexcept { return ring.size(); };
+
+		size_type resident_bytes() const noexcept { return ring.size() * chunk_bytes; };
+
+		size_type budget_bytes() const noexcept { return max_resident * chunk_bytes; };
+
+		const SpillStats& stats() const noexcept { return counters; };
+
+		/// MODIFIERS
+
+		void push_back(const T& value) {
+			if (list_size == slots.size() * N) {
+				slots.emplace_back();
+				// A new chunk has nothing to read
+				make_room(slots.size() - 1);
+				slot_type& slot = slots.back();
+				slot.data.reset(new T[N]);
+				slot.dirty = true;
+				make_resident(slots.size() - 1);
+			}
+			slot_type& slot = fault(slots.size() - 1);
+			slot.data[slot.count++] = value;
+			slot.dirty = true;
+			list_size++;
+		};
+
+		void pop_back() {
+			if (list_size == 0)
+				return;
+			slot_type& slot = slots.back();
+			slot.count--;
+			list_size--;
+			if (slot.count == 0) {
+				if (slot.loading.valid())
+					slot.loading.wait();
+				if (slot.data != nullptr)
+					remove_from_ring(slots.size() - 1);
+				slots.pop_back();
+			}
+		};
+
+		/// @brief Removes every element and empties the spill file.
+		void clear() {
+			for (auto& slot : slots)
+				if (slot.loading.valid())
+					slot.loading.wait();
+			slots.clear();
+			ring.clear();
+			hand = 0;
+			list_size = 0;
+			last_accessed = npos;
+			if (::ftruncate(fd, 0) != 0)
+				throw std::system_error(errno, std::generic_category(), "ftruncate");
+		};
+
+	private:
+		static constexpr size_type npos = static_cast<size_type>(-1);
+
+		struct slot_type {
+			/// @brief Storage of the chunk while resident, nullptr while evicted.
+			std::unique_ptr<T[]> data;
+			/// @brief Pending read ahead into data. Declared after data, so it is
+			/// waited for before data is freed.
+			std::future<void> loading;
+			size_type count = 0;
+			size_type ring_index = 0;
+			bool referenced = false;
+			bool dirty = false;
+			bool prefetched = false;
+		};
+
+		/// @brief Makes chunk_index resident and marks it as recently used.
+		slot_type& fault(size_type chunk_index) const {
+			slot_type& slot = slots[chunk_index];
+			if (slot.data == nullptr) {
+				counters.faults++;
+				make_room(chunk_index);
+				slot.data.reset(new T[N]);
+				read_chunk(chunk_index, slot.data.get(), slot.count);
+				slot.dirty = false;
+				make_resident(chunk_index);
+			}
+			else if (slot.loading.valid()) {
+				slot.loading.get();
+			}
+			if (slot.prefetched) {
+				counters.prefetch_hits++;
+				slot.prefetched = false;
+			}
+			slot.referenced = true;
+
+			if (chunk_index != last_accessed) {
+				if (chunk_index == last_accessed + 1)
+					read_ahead(chunk_index);
+				last_accessed = chunk_index;
+			}
+			return slot;
+		}
+
+		/// @brief Starts background reads of the evicted chunks following
+		/// chunk_index.
+		void read_ahead(size_type chunk_index) const {
+			for (size_type next = chunk_index + 1; next <= chunk_index + depth && next < slots.size(); next++) {
+				slot_type& slot = slots[next];
+				if (slot.data != nullptr)
+					continue;
+				make_room(chunk_index);
+				slot.data.reset(new T[N]);
+				slot.dirty = false;
+				slot.prefetched = true;
+				slot.loading = std::async(std::launch::async,
+					[fd = fd, data = slot.data.get(), count = slot.count, next]() {
+						read_chunk(fd, next, data, count);
+					});
+				make_resident(next);
+				counters.prefetches++;
+			}
+		}
+
+		/// @brief Evicts chunks until one more fits in the budget. Chunks being
+		/// read ahead and the pinned chunk are skipped.
+		void make_room(size_type pinned) const {
+			size_type skipped = 0;
+			while (ring.size() >= max_resident) {
+				size_type victim = ring[hand];
+				slot_type& slot = slots[victim];
+				if (victim == pinned || slot.loading.valid()) {
+					if (++skipped > 2 * ring.size() && slot.loading.valid())
+						slot.loading.get();
+					hand = (hand + 1) % ring.size();
+					continue;
+				}
+				if (slot.referenced) {
+					slot.referenced = false;
+					hand = (hand + 1) % ring.size();
+					continue;
+				}
+				if (slot.dirty) {
+					write_chunk(victim, slot.data.get(), slot.count);
+					counters.writebacks++;
+				}
+				slot.data.reset();
+				slot.prefetched = false;
+				remove_from_ring(victim);
+				counters.evictions++;
+			}
+		}
+
+		void make_resident(size_type chunk_index) const {
+			slots[chunk_index].ring_index = ring.size();
+			slots[chunk_index].referenced = false;
+			ring.push_back(chunk_index);
+		}
+
+		void remove_from_ring(size_type chunk_index) const {
+			size_type index = slots[chunk_index].ring_index;
+			ring[index] = ring.back();
+			slots[ring[index]].ring_index = index;
+			ring.pop_back();
+			if (hand >= ring.size())
+				hand = 0;
+		}
+
+		void read_chunk(size_type chunk_index, T* data, size_type count) const {
+			read_chunk(fd, chunk_index, data, count);
+		}
+
+		static void read_chunk(int fd, size_type chunk_index, T* data, size_type count) {
+			char* bytes = reinterpret_cast<char*>(data);
+			size_type left = count * sizeof(T);
+			off_t offset = static_cast<off_t>(chunk_index * chunk_bytes);
+			while (left > 0) {
+				ssize_t got = ::pread(fd, bytes, left, offset);
+				if (got < 0 && errno == EINTR)
+					continue;
+				if (got < 0)
+					throw std::system_error(errno, std::generic_category(), "pread");
+				if (got == 0)
+					throw std::runtime_error("Spill file is shorter than expected");
+				bytes += got;
+				offset += got;
+				left -= static_cast<size_type>(got);
+			}
+		}
+
+		void write_chunk(size_type chunk_index, const T* data, size_type count) const {
+			const char* bytes = reinterpret_cast<const char*>(data);
+			size_type left = count * sizeof(T);
+			off_t offset = static_cast<off_t>(chunk_index * chunk_bytes);
+			while (left > 0) {
+				ssize_t written = ::pwrite(fd, bytes, left, offset);
+				if (written < 0 && errno == EINTR)
+					continue;
+				if (written < 0)
+					throw std::system_error(errno, std::generic_category(), "pwrite");
+				bytes += written;
+				offset += written;
+				left -= static_cast<size_type>(written);
+			}
+		}
+
+		std::string path;
+		int fd = -1;
+		size_type max_resident;
+		size_type depth = 0;
+		size_type list_size = 0;
+
+		// The cache changes on const access as well, with no synchronization
+		mutable std::vector<slot_type> slots;
+		mutable std::vector<size_type> ring;
+		mutable size_type hand = 0;
+		mutable size_type last_accessed = npos;
+		mutable SpillStats counters;
+	};
+}  // namespace fefu_laboratory_two